@@ -1,48 +1,188 @@
 /*
- * ILP Solver Module (**Demo**)
+ * ILP Solver Module
  *
- *  This module is a ^^^DEMO^^^ Module for solving a sudoku board. This module uses
- *  backtracking for solving the board. In eclipse, the real ILP Module doesn't pass
- *  compilation, so here we are going to use this demo module. The real one will be used once we
- *  work on the nova server
+ *  This module solves a sudoku board as an integer linear program: a binary variable for every
+ *  (cell,value) pair, and an equality constraint for every cell and for every value in every row,
+ *  column and block. The program is solved by the in-tree simplex module (presolve, simplex and
+ *  branch and bound). If the simplex gives up (it reached its iterations limit, or lost its basis to
+ *  rounding errors), the board is solved by the backtracking engine, so a board is never reported
+ *  unsolvable without a proof.
+ *  Building with ILP=backtrack (-DILP_BACKTRACK) replaces it by the plain backtracking demo solver.
 */
 
+#include <stdio.h>
+#include <stdlib.h>
 #include "solver.h"
 #include "game.h"
+#include "stack.h"
+#include "mainAux.h"
+#include "simplex.h"
+#include "backtrack.h"
+#include "arena.h"
+
+static unsigned long nodesCount = 0; /* search nodes of the last run */
+
+/* private methods declaration: */
+#ifdef ILP_BACKTRACK
+int nextEmptyCell(Board *userBoard, int from);
+#else
+void addUnitConstraint(Model *model, int *vars, double *ones, Board *userBoard, int unit, int value, int kind);
+#endif
 
 /* Public methods: */
+#ifdef ILP_BACKTRACK
 int ilpSolve(Board *userBoard)
 {
-	int i,j,k;
-	int size;
+	int cell,k,size,solved=0;
+	Stack *stack;
 
 	/* dimensions definition: */
 	size=userBoard->boardsize;
+	nodesCount = 1;
 
-	for(i=0;i<size;i++)
+	cell = nextEmptyCell(userBoard, 0);
+	if(cell==-1) /* nothing to fill */
+		return 1;
+
+	/* every node is an empty cell and the value it holds now (0 = no value was tried yet).
+	 * the cells are filled in order, so the search is never deeper than the number of cells */
+	stack = initArenaStack(size*size);
+	push(stack,cell/size,cell%size,0);
+	while(!isEmpty(stack))
 	{
-		for(j=0;j<size;j++)
+		/* move the top cell to its next valid value */
+		for(k=top(stack)->value+1;k<=size;k++)
+			if(isValid(userBoard,top(stack)->column,top(stack)->row,k)==1)
+				break;
+		if(k>size) /* no value left - empty the cell and go back to the previous one */
 		{
-			if(userBoard->cells[i][j].fixed==0 && userBoard->cells[i][j].value==0)
-			{
-				for (k=1;k<=size;k++)
-				{
+			setCellValue(userBoard,top(stack)->column,top(stack)->row,0);
+			pop(stack,NULL);
+			continue;
+		}
+		setCellValue(userBoard,top(stack)->column,top(stack)->row,k);
+		top(stack)->value = k;
+		nodesCount++;
 
-					if (isValid(userBoard,i, j, k)==1)
-					{
-						userBoard->cells[i][j].value = k;
+		/* continue from the cell after the top one - the ones before it are all filled */
+		cell = nextEmptyCell(userBoard, CELL(userBoard,top(stack)->column,top(stack)->row)+1);
+		if(cell==-1)
+		{
+			solved = 1;
+			break;
+		}
+		push(stack,cell/size,cell%size,0);
+	}
+	destroyStack(stack);
+	return solved;
+}
 
-						if (ilpSolve(userBoard))
-							return 1;
-					}
+#else
+int ilpSolve(Board *userBoard)
+{
+	int cell,value,size,unit,kind,solved,status;
+	int *vars;
+	double *ones;
+	Model *model;
 
-				}
+	/* dimensions definition: */
+	size=userBoard->boardsize;
 
-				userBoard->cells[i][j].value=0;
-				return 0;
-			}
+	/* variable cell*size+value-1 is 1 iff the cell holds the value. the presolve fixes the given cells'
+	 * variables and propagates them, so only the open part of the board gets to the simplex */
+	model = initModel(size*size*size);
+	for(cell=0;cell<size*size;cell++)
+		for(value=1;value<=size;value++)
+		{
+			setVarInteger(model,cell*size+value-1);
+			if(userBoard->values[cell]==0)
+				setVarBounds(model,cell*size+value-1,0,1);
+			else
+				setVarBounds(model,cell*size+value-1,userBoard->values[cell]==value,1);
+		}
 
+	vars = arenaAlloc(size*sizeof(int));
+	ones = arenaAlloc(size*sizeof(double));
+	for(value=0;value<size;value++)
+		ones[value] = 1;
+	/* every cell has one value */
+	for(cell=0;cell<size*size;cell++)
+	{
+		for(value=1;value<=size;value++)
+			vars[value-1] = cell*size+value-1;
+		addConstraint(model,vars,ones,size,'=',1);
+	}
+	/* every value is once in every row (kind 0), column (kind 1) and block (kind 2) */
+	for(kind=0;kind<3;kind++)
+		for(unit=0;unit<size;unit++)
+			for(value=1;value<=size;value++)
+				addUnitConstraint(model,vars,ones,userBoard,unit,value,kind);
+
+	status = solveModel(model);
+	solved = status==MODEL_OPTIMAL;
+	if(solved)
+		for(cell=0;cell<size*size;cell++)
+			for(value=1;value<=size && userBoard->values[cell]==0;value++)
+				if(model->solution[cell*size+value-1]>0.5)
+					setCellValue(userBoard,cell/size,cell%size,value);
+	nodesCount = model->nodes;
+	/* the simplex gave up, which says nothing about the board - the backtracking answers instead */
+	if(status==MODEL_LIMIT)
+	{
+		solved = backtrackSolve(userBoard);
+		nodesCount += backtrackNodesCount();
+	}
+	destroyModel(model);
+	return solved;
+}
+#endif
+
+unsigned long ilpNodesCount()
+{
+	return nodesCount;
+}
+
+/* Private methods: */
+
+#ifdef ILP_BACKTRACK
+/*
+ * nextEmptyCell
+ *
+ *  This function returns the index of the first empty cell from the given index on (-1 if there is none)
+ */
+int nextEmptyCell(Board *userBoard, int from)
+{
+	int cell, cellsNum=userBoard->boardsize*userBoard->boardsize;
+	for(cell=from;cell<cellsNum;cell++)
+		if(userBoard->fixed[cell]==0 && userBoard->values[cell]==0)
+			return cell;
+	return -1;
+}
+#else
+/*
+ * addUnitConstraint
+ *
+ *  This function adds the constraint that a value appears once in a row (kind 0), a column (kind 1)
+ *  or a block (kind 2). block b starts at row (b/m)*m and column (b%m)*n.
+ */
+void addUnitConstraint(Model *model, int *vars, double *ones, Board *userBoard, int unit, int value, int kind)
+{
+	int i,row,column,size=userBoard->boardsize;
+	for(i=0;i<size;i++)
+	{
+		if(kind==0)
+			row=unit, column=i;
+		else if(kind==1)
+			row=i, column=unit;
+		else
+		{
+			row=(unit/userBoard->m)*userBoard->m + i/userBoard->n;
+			column=(unit%userBoard->m)*userBoard->n + i%userBoard->n;
 		}
+		vars[i] = CELL(userBoard,row,column)*size+value-1;
 	}
-	return 1;
+	addConstraint(model,vars,ones,size,'=',1);
 }
+#endif
+
+/* End of private methods */
@@ -3,4 +3,6 @@
 
 int ilpSolve(Board *userBoard);
 
+unsigned long ilpNodesCount();
+
 #endif /* ILPSOLVER_H_ */
@@ -0,0 +1,318 @@
+/*
+ * All-Different Module
+ *
+ *  This module checks the rule "all the values of a row, column or box are different" as a whole, and
+ *  not cell by cell: the empty cells of a unit have to be matched to the unit's missing values, every cell
+ *  to one of its valid values (a bipartite matching). If there is no such matching, the board is unsolvable.
+ *  A value which is not a part of any such matching is removed from the cell's candidates (Regin's
+ *  filtering), and the units are filtered again and again until nothing changes.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "game.h"
+#include "mainAux.h"
+#include "arena.h"
+#include "alldiff.h"
+
+/* The matching of one unit, and the work space for the filtering. the graph's nodes are the unit's empty
+ * cells (node i is cells[i]) and the values (node boardsize+v is value v+1). a matched cell points at its
+ * value, and a value points at the cells which have it as an unmatched candidate. */
+typedef struct matching {
+	int size; /* boardsize */
+	unsigned long *candidates;
+	size_t mark; /* the arena's top before initMatching - destroyMatching rewinds the arena to it */
+	int words;
+	int *cells;
+	int cellsNum;
+	int *cellValue; /* the value matched to every cell (0..size-1), -1 if none */
+	int *valueCell; /* the cell matched to every value, -1 if none */
+	char *seen; /* the values visited by the current augmenting search */
+	int *index; /* Tarjan's strongly connected components, for all the 2*size nodes */
+	int *low;
+	int *component;
+	int *nodesStack;
+	char *onStack;
+	char *reached; /* the nodes which can be reached from a free value */
+	int counter;
+	int stackNum;
+	int componentsNum;
+} Matching;
+
+/* private methods declaration: */
+Matching* initMatching(Board *board, unsigned long *candidates);
+void destroyMatching(Matching *matching);
+int filterUnit(Board *board, Matching *matching, int kind, int unit);
+int hasCandidate(Matching *matching, int cell, int value);
+int augment(Matching *matching, int cell);
+int nextNode(Matching *matching, int node, int after);
+void strongConnect(Matching *matching, int node);
+void reach(Matching *matching, int node);
+
+/* Public methods: */
+
+/*
+ * allDifferentFilter
+ *
+ *  This function filters the candidates of the board's empty cells by the matchings of all the rows,
+ *  columns and boxes, until no more candidates are removed
+ *  @param board - the game board
+ *  @param candidates - array of boardsize*boardsize*wordsPerUnit words which gets the candidates of every
+ *                      cell (bit value-1 of the cell's words, as in the digits bitsets, 0 for filled cells).
+ *                      can be NULL if only the answer is needed.
+ *  @return - 0 if some unit has no matching, so the board is unsolvable, 1 otherwise
+ */
+int allDifferentFilter(Board *board, unsigned long *candidates)
+{
+	int cell, word, kind, unit, result=1, changed=1, N=board->boardsize, words=board->wordsPerUnit;
+	unsigned long valid;
+	Matching *matching;
+
+	matching = initMatching(board, candidates);
+	/* the first candidates are the values which are not used in the cell's row, column and box */
+	for (cell=0; cell<N*N; cell++)
+		for (word=0; word<words; word++)
+		{
+			valid = (N-word*(int)WORDBITS >= (int)WORDBITS) ? ~0UL : (1UL<<(N-word*(int)WORDBITS))-1;
+			matching->candidates[cell*words+word] = board->values[cell]!=0 ? 0 :
+					valid & ~(board->rowDigits[(cell/N)*words+word] | board->columnDigits[(cell%N)*words+word]
+					| board->boxDigits[BOX(board,cell/N,cell%N)*words+word]);
+		}
+
+	while (changed && result)
+	{
+		changed = 0;
+		/* rows, columns and boxes */
+		for (kind=0; kind<3 && result; kind++)
+			for (unit=0; unit<N && result; unit++)
+			{
+				switch (filterUnit(board, matching, kind, unit))
+				{
+				case -1:
+					result = 0;
+					break;
+				case 1:
+					changed = 1;
+					break;
+				}
+			}
+	}
+	destroyMatching(matching);
+	return result;
+}
+
+/* End of public methods */
+
+/* Private methods: */
+
+/*
+ * initMatching
+ *
+ *  This function allocates the matching's work space in the command's arena. if candidates is NULL, the
+ *  candidates array is allocated too.
+ */
+Matching* initMatching(Board *board, unsigned long *candidates)
+{
+	int N=board->boardsize;
+	size_t mark = arenaMark();
+	Matching *matching = arenaAlloc(sizeof(Matching));
+	matching->mark = mark;
+	matching->size = N;
+	matching->words = board->wordsPerUnit;
+	matching->candidates = candidates ? candidates : arenaAlloc(N*N*board->wordsPerUnit*sizeof(unsigned long));
+	matching->cells = arenaAlloc(N*sizeof(int));
+	matching->cellValue = arenaAlloc(N*sizeof(int));
+	matching->valueCell = arenaAlloc(N*sizeof(int));
+	matching->seen = arenaAlloc(N*sizeof(char));
+	matching->index = arenaAlloc(2*N*sizeof(int));
+	matching->low = arenaAlloc(2*N*sizeof(int));
+	matching->component = arenaAlloc(2*N*sizeof(int));
+	matching->nodesStack = arenaAlloc(2*N*sizeof(int));
+	matching->onStack = arenaAlloc(2*N*sizeof(char));
+	matching->reached = arenaAlloc(2*N*sizeof(char));
+	return matching;
+}
+
+/*
+ * destroyMatching
+ *
+ *  This function gives the matching's work space back to the arena
+ */
+void destroyMatching(Matching *matching)
+{
+	arenaRewind(matching->mark);
+}
+
+/*
+ * filterUnit
+ *
+ *  This function matches the empty cells of a unit to values, and removes the candidates which are not
+ *  a part of any maximum matching: a candidate (cell,value) is kept if it is matched, if the value and the
+ *  cell are in one strongly connected component (an alternating cycle), or if the value can be reached from
+ *  a free value (an alternating path).
+ *  kind - 0 for a row, 1 for a column, 2 for a box.
+ *  returns -1 if some cell cannot be matched, 1 if candidates were removed, 0 otherwise.
+ */
+int filterUnit(Board *board, Matching *matching, int kind, int unit)
+{
+	int i, v, owner, node, removed=0, N=matching->size;
+	int *component=matching->component;
+
+	matching->cellsNum = 0;
+	for (i=0; i<N; i++)
+		if (board->values[unitCell(board, kind, unit, i)]==0)
+			matching->cells[matching->cellsNum++] = unitCell(board, kind, unit, i);
+	if (matching->cellsNum==0)
+		return 0;
+
+	for (v=0; v<N; v++)
+		matching->valueCell[v] = -1;
+	for (i=0; i<matching->cellsNum; i++)
+	{
+		matching->cellValue[i] = -1;
+		for (v=0; v<N; v++)
+			matching->seen[v] = 0;
+		if (!augment(matching, i))
+			return -1;
+	}
+
+	/* the strongly connected components, and the nodes which alternating paths from free values reach */
+	for (node=0; node<2*N; node++)
+	{
+		matching->index[node] = -1;
+		matching->onStack[node] = 0;
+		matching->reached[node] = 0;
+	}
+	matching->counter = matching->stackNum = matching->componentsNum = 0;
+	for (node=0; node<2*N; node++)
+		if (matching->index[node]==-1 && (node>=N || node<matching->cellsNum))
+			strongConnect(matching, node);
+	for (v=0; v<N; v++)
+	{
+		if (matching->valueCell[v]!=-1)
+			continue;
+		for (i=0; i<matching->cellsNum && !hasCandidate(matching, i, v); i++);
+		if (i<matching->cellsNum) /* a free value which is a candidate of some cell */
+			reach(matching, N+v);
+	}
+
+	for (i=0; i<matching->cellsNum; i++)
+		for (v=0; v<N; v++)
+		{
+			if (!hasCandidate(matching, i, v) || matching->cellValue[i]==v)
+				continue;
+			if (matching->reached[N+v] || component[N+v]==component[i])
+				continue;
+			owner = matching->cells[i];
+			matching->candidates[owner*matching->words+v/(int)WORDBITS] &= ~(1UL<<(v%(int)WORDBITS));
+			removed = 1;
+		}
+	return removed;
+}
+
+/*
+ * hasCandidate
+ *
+ *  This function checks whether value v (0..boardsize-1) is a candidate of the unit's i'th empty cell
+ */
+int hasCandidate(Matching *matching, int cell, int value)
+{
+	int words=matching->words;
+	return (matching->candidates[matching->cells[cell]*words+value/(int)WORDBITS] >> (value%(int)WORDBITS)) & 1UL;
+}
+
+/*
+ * augment
+ *
+ *  This function looks for an augmenting path from an unmatched cell: a value which is free, or whose cell
+ *  can move to another value. returns 1 if the matching grew.
+ */
+int augment(Matching *matching, int cell)
+{
+	int v;
+	for (v=0; v<matching->size; v++)
+	{
+		if (matching->seen[v] || !hasCandidate(matching, cell, v))
+			continue;
+		matching->seen[v] = 1;
+		if (matching->valueCell[v]==-1 || augment(matching, matching->valueCell[v]))
+		{
+			matching->valueCell[v] = cell;
+			matching->cellValue[cell] = v;
+			return 1;
+		}
+	}
+	return 0;
+}
+
+/*
+ * nextNode
+ *
+ *  This function returns the first node after "after" which the node points at (after=-1 for the first
+ *  one), or -1 if there is none. a cell points at its matched value, a value at the cells which have it as
+ *  an unmatched candidate.
+ */
+int nextNode(Matching *matching, int node, int after)
+{
+	int i, N=matching->size;
+	if (node<N)
+		return after==-1 ? N+matching->cellValue[node] : -1;
+	for (i=after+1; i<matching->cellsNum; i++)
+		if (matching->cellValue[i]!=node-N && hasCandidate(matching, i, node-N))
+			return i;
+	return -1;
+}
+
+/*
+ * strongConnect
+ *
+ *  This function is Tarjan's algorithm from a node: every node gets the number of its strongly
+ *  connected component
+ */
+void strongConnect(Matching *matching, int node)
+{
+	int next, top;
+	matching->index[node] = matching->low[node] = matching->counter++;
+	matching->nodesStack[matching->stackNum++] = node;
+	matching->onStack[node] = 1;
+
+	for (next=nextNode(matching, node, -1); next!=-1; next=nextNode(matching, node, next))
+	{
+		if (matching->index[next]==-1)
+		{
+			strongConnect(matching, next);
+			if (matching->low[next]<matching->low[node])
+				matching->low[node] = matching->low[next];
+		}
+		else if (matching->onStack[next] && matching->index[next]<matching->low[node])
+			matching->low[node] = matching->index[next];
+	}
+
+	if (matching->low[node]==matching->index[node])
+	{
+		do
+		{
+			top = matching->nodesStack[--matching->stackNum];
+			matching->onStack[top] = 0;
+			matching->component[top] = matching->componentsNum;
+		} while (top!=node);
+		matching->componentsNum++;
+	}
+}
+
+/*
+ * reach
+ *
+ *  This function marks the nodes which can be reached from a node
+ */
+void reach(Matching *matching, int node)
+{
+	int next;
+	if (matching->reached[node])
+		return;
+	matching->reached[node] = 1;
+	for (next=nextNode(matching, node, -1); next!=-1; next=nextNode(matching, node, next))
+		reach(matching, next);
+}
+
+/* End of private methods */
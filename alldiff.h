@@ -0,0 +1,29 @@
+/*
+ * All-Different Module
+ *
+ *  This module checks the rule "all the values of a row, column or box are different" as a whole, and
+ *  not cell by cell: the empty cells of a unit have to be matched to the unit's missing values, every cell
+ *  to one of its valid values (a bipartite matching). If there is no such matching, the board is unsolvable.
+ *  A value which is not a part of any such matching is removed from the cell's candidates (Regin's
+ *  filtering), and the units are filtered again and again until nothing changes.
+ */
+
+#ifndef ALLDIFF_H_
+#define ALLDIFF_H_
+
+#include "game.h"
+
+/*
+ * allDifferentFilter
+ *
+ *  This function filters the candidates of the board's empty cells by the matchings of all the rows,
+ *  columns and boxes, until no more candidates are removed
+ *  @param board - the game board
+ *  @param candidates - array of boardsize*boardsize*wordsPerUnit words which gets the candidates of every
+ *                      cell (bit value-1 of the cell's words, as in the digits bitsets, 0 for filled cells).
+ *                      can be NULL if only the answer is needed.
+ *  @return - 0 if some unit has no matching, so the board is unsolvable, 1 otherwise
+ */
+int allDifferentFilter(Board *board, unsigned long *candidates);
+
+#endif /* ALLDIFF_H_ */
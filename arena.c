@@ -0,0 +1,190 @@
+/*
+ * Arena Module
+ *
+ *  This module keeps the memory of a command's temporaries. It is a bump allocator: the memory is handed out
+ *  of big blocks, so a temporary costs no malloc call and no free call, and all the memory of a command is
+ *  released at once when the command ends. A function which runs many times in one command (solveBoard in
+ *  generate) gives back its own temporaries by rewinding the arena to a mark it took before.
+ *  The arena counts the bytes and the allocations of every command, for the stats command. Only the main
+ *  thread uses the arena (the counting threads allocate by themselves).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "arena.h"
+
+#define ARENA_BLOCK 65536 /* the size of a block, unless an allocation needs more */
+
+/* the types the arena's memory has to be aligned for */
+typedef union align {
+	long l;
+	double d;
+	void *p;
+} Align;
+
+#define ALIGNED(size) (((size)+sizeof(Align)-1)/sizeof(Align)*sizeof(Align))
+
+/* A block of the arena. the memory follows the header. base is the arena's top when the block was
+ * added (the unused end of the block below it counts as used), so a mark is base+used */
+typedef struct block {
+	size_t base;
+	size_t size;
+	size_t used;
+	struct block *prev;
+} Block;
+
+#define HEADER ALIGNED(sizeof(Block))
+
+static Block *top = NULL; /* the block which allocates now, its prev ones are full */
+static Block *spare = NULL; /* a block which was rewound, kept for the next command */
+static unsigned long commandBytes = 0, commandAllocations = 0; /* the counters of the current command */
+static unsigned long lastBytes = 0, lastAllocations = 0; /* the counters of the last command which used the arena */
+
+/* private methods declaration: */
+void pushBlock(size_t size);
+void popBlock();
+
+/* Public methods: */
+
+/*
+ * arenaAlloc
+ *
+ *  This function allocates memory for a temporary of the current command. the memory is aligned for any type,
+ *  and is valid until the arena is rewound below it or released.
+ *  @param size - the number of bytes
+ *  @return - pointer to the memory
+ */
+void* arenaAlloc(size_t size)
+{
+	void *memory;
+	size = ALIGNED(size>0 ? size : 1);
+	if (top==NULL || top->used+size > top->size)
+		pushBlock(size);
+	memory = (char*)top + HEADER + top->used;
+	top->used += size;
+	commandBytes += size;
+	commandAllocations++;
+	return memory;
+}
+
+/*
+ * arenaMark
+ *
+ *  This function returns the current top of the arena, for arenaRewind
+ *  @return - the mark
+ */
+size_t arenaMark()
+{
+	return top ? top->base+top->used : 0;
+}
+
+/*
+ * arenaRewind
+ *
+ *  This function gives back all the memory which was allocated after the mark was taken. marks have to be
+ *  rewound in the reverse order of taking them.
+ *  @param mark - a mark from arenaMark
+ *  @return -
+ */
+void arenaRewind(size_t mark)
+{
+	while (top!=NULL && top->base>mark)
+		popBlock();
+	if (top!=NULL)
+		top->used = mark-top->base;
+}
+
+/*
+ * arenaRelease
+ *
+ *  This function releases all the memory of the command which has ended, and keeps its counters if it used
+ *  the arena
+ *  @return -
+ */
+void arenaRelease()
+{
+	arenaRewind(0);
+	if (commandAllocations>0)
+	{
+		lastBytes = commandBytes;
+		lastAllocations = commandAllocations;
+	}
+	commandBytes = commandAllocations = 0;
+}
+
+/*
+ * arenaBytes
+ *
+ *  This function returns the number of bytes the last command which used the arena has allocated
+ *  @return - number of bytes
+ */
+unsigned long arenaBytes()
+{
+	return lastBytes;
+}
+
+/*
+ * arenaAllocations
+ *
+ *  This function returns the number of allocations of the last command which used the arena
+ *  @return - number of allocations
+ */
+unsigned long arenaAllocations()
+{
+	return lastAllocations;
+}
+
+/* End of public methods */
+
+/* Private methods: */
+
+/*
+ * pushBlock
+ *
+ *  This function adds a block of at least size bytes on top of the arena (the spare one, if it is big enough)
+ */
+void pushBlock(size_t size)
+{
+	Block *block;
+	if (spare!=NULL && spare->size>=size)
+	{
+		block = spare;
+		spare = NULL;
+	}
+	else
+	{
+		if (size<ARENA_BLOCK)
+			size = ARENA_BLOCK;
+		block = malloc(HEADER+size);
+		if (!block)
+		{
+			printf("Error: malloc has failed\n");
+			exit(0);
+		}
+		block->size = size;
+	}
+	block->base = top ? top->base+top->size : 0;
+	block->used = 0;
+	block->prev = top;
+	top = block;
+}
+
+/*
+ * popBlock
+ *
+ *  This function removes the top block of the arena. the biggest removed block is kept as the spare one.
+ */
+void popBlock()
+{
+	Block *block = top;
+	top = block->prev;
+	if (spare==NULL || block->size>spare->size)
+	{
+		free(spare);
+		spare = block;
+	}
+	else
+		free(block);
+}
+
+/* End of private methods */
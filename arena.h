@@ -0,0 +1,70 @@
+/*
+ * Arena Module
+ *
+ *  This module keeps the memory of a command's temporaries. It is a bump allocator: the memory is handed out
+ *  of big blocks, so a temporary costs no malloc call and no free call, and all the memory of a command is
+ *  released at once when the command ends. A function which runs many times in one command (solveBoard in
+ *  generate) gives back its own temporaries by rewinding the arena to a mark it took before.
+ *  The arena counts the bytes and the allocations of every command, for the stats command. Only the main
+ *  thread uses the arena (the counting threads allocate by themselves).
+ */
+
+#ifndef ARENA_H_
+#define ARENA_H_
+
+#include <stddef.h>
+
+/*
+ * arenaAlloc
+ *
+ *  This function allocates memory for a temporary of the current command. the memory is aligned for any type,
+ *  and is valid until the arena is rewound below it or released.
+ *  @param size - the number of bytes
+ *  @return - pointer to the memory
+ */
+void* arenaAlloc(size_t size);
+
+/*
+ * arenaMark
+ *
+ *  This function returns the current top of the arena, for arenaRewind
+ *  @return - the mark
+ */
+size_t arenaMark();
+
+/*
+ * arenaRewind
+ *
+ *  This function gives back all the memory which was allocated after the mark was taken. marks have to be
+ *  rewound in the reverse order of taking them.
+ *  @param mark - a mark from arenaMark
+ *  @return -
+ */
+void arenaRewind(size_t mark);
+
+/*
+ * arenaRelease
+ *
+ *  This function releases all the memory of the command which has ended, and keeps its counters if it used
+ *  the arena
+ *  @return -
+ */
+void arenaRelease();
+
+/*
+ * arenaBytes
+ *
+ *  This function returns the number of bytes the last command which used the arena has allocated
+ *  @return - number of bytes
+ */
+unsigned long arenaBytes();
+
+/*
+ * arenaAllocations
+ *
+ *  This function returns the number of allocations of the last command which used the arena
+ *  @return - number of allocations
+ */
+unsigned long arenaAllocations();
+
+#endif /* ARENA_H_ */
@@ -0,0 +1,700 @@
+/*
+ * Backtrack Module
+ *
+ *  This module solves and counts sudoku boards by an iterative backtracking, which simulates the recursion
+ *  with a stack. Every level deals with the empty cell which has the fewest options (or with the cell of a
+ *  hidden single), and the options counters and the valid values masks of the cells are kept updated on every
+ *  assignment (and restored from the stack's trail on backtrack).
+ *  The search is conflict-directed: every level keeps the levels whose assignments made its values fail,
+ *  and when all the values failed the search jumps straight back to the deepest of them. These conflicts
+ *  are also kept as nogoods, which cut the same failure when it shows up again in another branch.
+ *  A search of the main thread keeps its work space in the command's arena. the counting threads, which
+ *  cannot use the arena, allocate it by themselves.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "game.h"
+#include "solver.h"
+#include "stack.h"
+#include "mainAux.h"
+#include "parallel.h"
+#include "propagate.h"
+#include "arena.h"
+#include "backtrack.h"
+
+#define NOGOODS_MAX 1024 /* size of the nogoods store - a new nogood replaces the oldest one */
+#define NOGOOD_LENGTH 6 /* longer nogoods are not stored */
+
+/* A set of assignments (cell=value) which cannot all be a part of a solution */
+typedef struct nogood {
+	int length; /* 0 for an empty slot */
+	int cells[NOGOOD_LENGTH];
+	int values[NOGOOD_LENGTH];
+} Nogood;
+
+/* The state of the conflict-directed backjumping of one search */
+typedef struct search {
+	int *levelOf; /* the stack level of every assigned cell (-1 for the given cells) */
+	unsigned long *conflicts; /* for every level, the set of levels whose assignments made its values fail */
+	int words; /* words of a levels set */
+	char *solutionBelow; /* a solution was found under the level, so the search must not jump over it */
+	Nogood *nogoods;
+	int nextNogood; /* the slot which is replaced next */
+	int *watchHead; /* for every cell, the first nogood entry (slot*NOGOOD_LENGTH+place) which has the cell */
+	int *watchNext;
+	unsigned long skipped; /* levels jumped over and assignments cut by nogoods */
+	int inArena; /* the state is in the arena */
+} Search;
+
+static unsigned long nodesCount = 0; /* search nodes of the last run */
+static unsigned long skippedCount = 0; /* nodes the last run skipped by backjumping and nogoods */
+
+/* private methods declaration: */
+unsigned long searchSolutions(Board* board, unsigned long limit, int keepSolution, int (*onSolution)(Board *board, void *data),
+		void *data, unsigned long* nodes, unsigned long* skipped, int inArena);
+void* searchAlloc(size_t size, int inArena);
+void searchFree(void* memory, int inArena);
+int hasCollisions(Board* board);
+int chooseCell(Board* board, int* options, unsigned long* masks);
+int nextOption(Board* board, int row, int column, int value);
+void addAssignment(Board* board, int* options, unsigned long* masks, Stack* stack, int value);
+void removeAssignment(Board* board, int* options, unsigned long* masks, Stack* stack);
+Search* initSearch(Board* board, int inArena);
+void destroySearch(Search* search);
+void addConflict(Search* search, int level, int culprit);
+int culprit(Board* board, Search* search, int cell, int value);
+void explainCell(Board* board, Search* search, int level, int cell);
+void explainUnit(Board* board, Search* search, int level);
+int backjump(Board* board, int* options, unsigned long* masks, Stack* stack, Search* search);
+void recordNogood(Board* board, Search* search, Stack* stack, int level);
+int checkNogoods(Board* board, Search* search, int cell, int value, int level);
+
+/* Public methods: */
+
+/*
+ * backtrackSolve
+ *
+ *  This function finds a solution of the board and fills the board's empty cells with it.
+ *  the board is not changed if there is no solution.
+ *  @param board - the board to solve
+ *  @return - 1 if solved, 0 if the board is unsolvable
+ */
+int backtrackSolve(Board *board)
+{
+	nodesCount = skippedCount = 0;
+	if(hasCollisions(board))
+		return 0;
+	return searchSolutions(board, 1, 1, NULL, NULL, &nodesCount, &skippedCount, 1);
+}
+
+/*
+ * backtrackCount
+ *
+ *  This function counts the solutions of the board, with the counting threads if there is no limit.
+ *  the board is not changed.
+ *  @param board - the board
+ *  @param limit - stop counting after that many solutions (0 = count them all)
+ *  @return - number of solutions (at most limit)
+ */
+unsigned long backtrackCount(Board *board, unsigned long limit)
+{
+	nodesCount = skippedCount = 0;
+	if(hasCollisions(board))
+		return 0;
+	/* split the search between threads if more than one thread was asked for */
+	if(limit==0 && getCountingThreads()>1)
+		return parallelCount(board, countSolutions, &nodesCount);
+	return searchSolutions(board, limit, 0, NULL, NULL, &nodesCount, &skippedCount, 1);
+}
+
+/*
+ * backtrackEnumerate
+ *
+ *  This function goes over all the solutions of the board. for each solution the board's empty cells
+ *  are filled with it and the callback is called. after the callback the cells are emptied again.
+ *  @param board - the board
+ *  @param onSolution - called for every solution, returns 0 in order to stop the enumeration
+ *  @param data - passed to the callback
+ *  @return - number of solutions visited
+ */
+unsigned long backtrackEnumerate(Board *board, int (*onSolution)(Board *board, void *data), void *data)
+{
+	nodesCount = skippedCount = 0;
+	if(hasCollisions(board))
+		return 0;
+	return searchSolutions(board, 0, 0, onSolution, data, &nodesCount, &skippedCount, 1);
+}
+
+/*
+ * backtrackNodesCount
+ *
+ *  This function returns the number of search nodes of the last backtracking run
+ *  @return - number of nodes
+ */
+unsigned long backtrackNodesCount()
+{
+	return nodesCount;
+}
+
+/*
+ * backtrackSkippedCount
+ *
+ *  This function returns the number of nodes the last backtracking run skipped: the levels it jumped over
+ *  and the assignments which nogoods cut
+ *  @return - number of skipped nodes
+ */
+unsigned long backtrackSkippedCount()
+{
+	return skippedCount;
+}
+
+/*
+ * countSolutions
+ *
+ *  This function counts the solutions of a board which has no errors. the board is given back unchanged.
+ *  the function uses no shared state, so threads may call it on their own boards.
+ *
+ *  @param board - the board (can be a copy of the game board)
+ *  @param nodes - pointer to a counter of search nodes, increased by the nodes this search visits
+ *  @return - number of possible solutions
+ */
+unsigned long countSolutions(Board* board, unsigned long* nodes)
+{
+	return searchSolutions(board, 0, 0, NULL, NULL, nodes, NULL, 0);
+}
+
+/* End of public methods */
+
+/* Private methods: */
+
+/*
+ * searchSolutions
+ *
+ *  This function goes over the solutions of a board which has no errors, by an iterative backtracking which
+ *  simulates the recursion with a stack. every level deals with the empty cell which has the fewest options.
+ *  when all the values of a level failed, the search jumps back to the deepest level in its conflict set.
+ *  limit - stop after that many solutions (0 = never). keepSolution - if the search stops on a solution,
+ *  the solution stays in the board. otherwise the board is given back unchanged.
+ *  onSolution - if not NULL, called for every solution while it is in the board. returns 0 to stop.
+ *  nodes, skipped - counters which are increased by the visited and the skipped nodes (skipped can be NULL).
+ *  inArena - 1 on the main thread: the work space is taken from the arena and given back at the end.
+ *  returns the number of found solutions.
+ */
+unsigned long searchSolutions(Board* board, unsigned long limit, int keepSolution, int (*onSolution)(Board *board, void *data),
+		void *data, unsigned long* nodes, unsigned long* skipped, int inArena)
+{
+	int i,cell,next,size,cellsNum,level;
+	unsigned long count;
+	size_t mark = inArena ? arenaMark() : 0;
+	int *options;
+	unsigned long *masks;
+	Stack* stack;
+	Search* search;
+	size=board->boardsize;
+	cellsNum=size*size;
+	count=0;
+
+	/* number of valid values of every empty cell (-1 for filled cells), kept updated on every assignment */
+	options = searchAlloc(cellsNum*sizeof(int), inArena);
+	/* the valid values of every cell for the hidden singles, also kept updated on every assignment */
+	masks = searchAlloc((cellsNum+2)*board->wordsPerUnit*sizeof(unsigned long), inArena);
+	for(i=0;i<cellsNum;i++)
+		options[i] = board->values[i]!=0 ? -1 : countOptions(board,i/size,i%size);
+	fillFreeDigits(board, masks);
+
+	/* find the first cell to deal with - the one with the fewest options */
+	cell = chooseCell(board, options, masks);
+	/* in case the board is full and valid, or has no solution at all */
+	if(cell<0)
+	{
+		if(cell==-1 && onSolution)
+			onSolution(board, data);
+		searchFree(options, inArena);
+		searchFree(masks, inArena);
+		if(inArena)
+			arenaRewind(mark);
+		return cell==-1;
+	}
+
+	/* the search is never deeper than the number of cells, so the stack never grows */
+	stack=inArena ? initArenaStack(cellsNum) : initStack(cellsNum);
+	search=initSearch(board, inArena);
+	push(stack,cell/size,cell%size,0); /* no value was tried yet */
+	/* if the stack is not empty, it means that there are still some cases to simulate  */
+	while(!isEmpty(stack)){
+		(*nodes)++;
+		level=stack->length-1;
+		/* take back the last tried value of the top cell and move to its next option */
+		if(top(stack)->value!=0)
+			removeAssignment(board,options,masks,stack);
+		next = nextOption(board,top(stack)->column,top(stack)->row,top(stack)->value);
+		if(next==0){ /* if we tried all the options, go back to the level which caused the failure */
+			if(!backjump(board,options,masks,stack,search))
+				break;
+			continue;
+		}
+		top(stack)->value = next;
+		addAssignment(board,options,masks,stack,next);
+		cell=CELL(board,top(stack)->column,top(stack)->row);
+		search->levelOf[cell]=level;
+		if(checkNogoods(board,search,cell,next,level))
+			continue;
+
+		cell = chooseCell(board, options, masks);
+		if(cell==-1) /* if we got here, it means that we solved the board*/
+		{
+			count = count + 1;
+			/* every level above may lead to more solutions, so there will be no jumps over them */
+			search->solutionBelow[level]=1;
+			if((onSolution && !onSolution(board,data)) || (limit!=0 && count>=limit))
+				break;
+		}
+		else if(cell==-2) /* some value has no place in its unit */
+			explainUnit(board,search,level);
+		else if(options[cell]>0) /* go one step further in our simulated recursion */
+		{
+			push(stack,cell/size,cell%size,0);
+			for(i=0;i<search->words;i++)
+				search->conflicts[(level+1)*search->words+i]=0;
+			search->solutionBelow[level+1]=0;
+		}
+		else /* some empty cell has no options - the next iteration tries another value */
+			explainCell(board,search,level,cell);
+	}
+	/* the stack is not empty only if the search stopped on a solution */
+	while(!keepSolution && !isEmpty(stack)){
+		removeAssignment(board,options,masks,stack);
+		pop(stack,NULL);
+	}
+	if(skipped)
+		(*skipped) += search->skipped;
+	/*free all memory resources that were used in function*/
+	searchFree(options, inArena);
+	searchFree(masks, inArena);
+	destroyStack(stack);
+	destroySearch(search);
+	if(inArena)
+		arenaRewind(mark);
+	return count; /* return the number of possible solutions */
+}
+
+/*
+ * searchAlloc
+ *
+ *  This function allocates zeroed work space of a search - in the arena (inArena=1) or by calloc
+ */
+void* searchAlloc(size_t size, int inArena)
+{
+	void *memory;
+	if(inArena)
+		return memset(arenaAlloc(size), 0, size);
+	memory = calloc(size, 1);
+	if(memory == NULL) {
+		printf("Error: calloc has failed\n");
+		exit(0);
+	}
+	return memory;
+}
+
+/*
+ * searchFree
+ *
+ *  This function frees work space of searchAlloc (memory in the arena is given back by rewinding it)
+ */
+void searchFree(void* memory, int inArena)
+{
+	if(!inArena)
+		free(memory);
+}
+
+/*
+ * hasCollisions
+ *
+ *  This function checks whether two filled cells hold the same value in a row, column or box.
+ *  the search relies on the digits bitsets, which cannot see such collisions. (main thread only - the
+ *  work space is in the arena)
+ */
+int hasCollisions(Board* board)
+{
+	int cell,value,row,column,N=board->boardsize,collision=0;
+	size_t mark = arenaMark();
+	char *used = searchAlloc(3*N*N*sizeof(char), 1);
+	for(cell=0;cell<N*N && !collision;cell++)
+	{
+		value=board->values[cell];
+		if(value==0)
+			continue;
+		row=cell/N, column=cell%N;
+		collision = used[row*N+value-1] || used[N*N+column*N+value-1] || used[2*N*N+BOX(board,row,column)*N+value-1];
+		used[row*N+value-1] = used[N*N+column*N+value-1] = used[2*N*N+BOX(board,row,column)*N+value-1] = 1;
+	}
+	arenaRewind(mark);
+	return collision;
+}
+
+/*
+ * chooseCell
+ *
+ *  This function finds the cell for the num_solution algorithm to deal with - the empty cell which has
+ *  the fewest options (most constrained), according to the options counters. if every cell has several
+ *  options, the cell of a hidden single is taken instead: its other values fail on the next level.
+ *  masks - the valid values masks of the search, for findUnitsHiddenSingle.
+ *  returns the cell's index, -1 if there are no empty cells, or -2 if some value cannot be placed in its unit.
+ */
+int chooseCell(Board* board, int* options, unsigned long* masks)
+{
+	int i, best=-1, value, hidden, cellsNum=board->boardsize*board->boardsize;
+	for(i=0;i<cellsNum;i++)
+	{
+		if(options[i]>=0 && (best==-1 || options[i]<options[best]))
+		{
+			best = i;
+			if(options[i]<=1) /* cannot find a better one */
+				return best;
+		}
+	}
+	if(best==-1)
+		return best;
+	hidden = findUnitsHiddenSingle(board, masks, &i, &value);
+	if(hidden==-1)
+		return -2;
+	return hidden==1 ? i : best;
+}
+
+/*
+ * nextOption
+ *
+ *  This function finds the smallest valid value of an empty cell which is bigger than "value", by going over
+ *  the bits of the digits which are not used in the cell's row, column and box.
+ *  returns 0 if there is no such value.
+ */
+int nextOption(Board* board, int row, int column, int value)
+{
+	int word, bit, firstWord, words=board->wordsPerUnit;
+	unsigned long freeDigits;
+	/* value+1 is at bit "value" */
+	firstWord = (int)(value/WORDBITS);
+	for(word=firstWord; word<words; word++)
+	{
+		freeDigits = ~(board->rowDigits[row*words+word] | board->columnDigits[column*words+word]
+				| board->boxDigits[BOX(board,row,column)*words+word]);
+		if(word==firstWord)
+			freeDigits &= ~0UL << (value%WORDBITS);
+		for(bit=0; freeDigits!=0; bit++, freeDigits>>=1)
+			if(freeDigits & 1UL)
+			{
+				value = (int)(word*WORDBITS)+bit+1;
+				return value<=board->boardsize ? value : 0;
+			}
+	}
+	return 0;
+}
+
+/*
+ * addAssignment
+ *
+ *  This function sets a value in the empty cell of the stack's top node and updates the options counters
+ *  and the valid values masks: every empty cell which shares a row, column or box with it loses an option,
+ *  unless the value was already used in its units. every changed counter is recorded on the stack's trail.
+ */
+void addAssignment(Board* board, int* options, unsigned long* masks, Stack* stack, int value)
+{
+	int i,row,column,cell,peer,peersNum,*peers,words,word;
+	unsigned long bit;
+	peersNum=board->geometry->peersNum, words=board->wordsPerUnit;
+	row=top(stack)->column, column=top(stack)->row;
+	/* value is at bit value-1 of its word */
+	word=(value-1)/(int)WORDBITS, bit=1UL<<((value-1)%WORDBITS);
+
+	cell=CELL(board,row,column);
+	pushTrail(stack,cell,options[cell]);
+	options[cell] = -1;
+	for(i=0;i<words;i++)
+		masks[(2+cell)*words+i] = 0;
+	/* the cells of the row, column and box, each one once */
+	peers=board->geometry->peers+cell*peersNum;
+	for(i=0;i<peersNum;i++)
+	{
+		peer=peers[i];
+		if(options[peer]>0 && (masks[(2+peer)*words+word] & bit))
+		{
+			pushTrail(stack,peer,options[peer]--);
+			masks[(2+peer)*words+word] &= ~bit;
+		}
+	}
+
+	setCellValue(board,row,column,value);
+}
+
+/*
+ * removeAssignment
+ *
+ *  This function empties the cell of the stack's top node, which was set by addAssignment, and restores
+ *  the options counters by popping the trail back to the node's mark. the cells on the trail are the
+ *  emptied cell, whose valid values are found again, and the cells which lost its value.
+ */
+void removeAssignment(Board* board, int* options, unsigned long* masks, Stack* stack)
+{
+	int cell,prevOptions,emptied,row,column,words,word;
+	unsigned long bit;
+	row=top(stack)->column, column=top(stack)->row, words=board->wordsPerUnit;
+	emptied=CELL(board,row,column);
+	word=(top(stack)->value-1)/(int)WORDBITS, bit=1UL<<((top(stack)->value-1)%WORDBITS);
+	setCellValue(board,row,column,0);
+	while(stack->trailLength>top(stack)->trailMark)
+	{
+		popTrail(stack,&cell,&prevOptions);
+		options[cell] = prevOptions;
+		if(cell!=emptied)
+			masks[(2+cell)*words+word] |= bit;
+	}
+	for(word=0;word<words;word++)
+		masks[(2+emptied)*words+word] = ~(board->rowDigits[row*words+word] | board->columnDigits[column*words+word]
+				| board->boxDigits[BOX(board,row,column)*words+word]);
+}
+
+/*
+ * initSearch
+ *
+ *  This function allocates the backjumping state of a search on the board: no cell is assigned, the
+ *  conflict sets are empty and there are no nogoods. inArena - the state is allocated in the arena.
+ */
+Search* initSearch(Board* board, int inArena)
+{
+	int i, cellsNum=board->boardsize*board->boardsize;
+	Search* search = searchAlloc(sizeof(Search), inArena);
+	search->inArena = inArena;
+	search->words = (cellsNum+WORDBITS-1)/WORDBITS;
+	search->levelOf = searchAlloc(cellsNum*sizeof(int), inArena);
+	search->conflicts = searchAlloc(cellsNum*search->words*sizeof(unsigned long), inArena);
+	search->solutionBelow = searchAlloc(cellsNum*sizeof(char), inArena);
+	search->nogoods = searchAlloc(NOGOODS_MAX*sizeof(Nogood), inArena);
+	search->watchHead = searchAlloc(cellsNum*sizeof(int), inArena);
+	search->watchNext = searchAlloc(NOGOODS_MAX*NOGOOD_LENGTH*sizeof(int), inArena);
+	for(i=0;i<cellsNum;i++)
+		search->levelOf[i] = search->watchHead[i] = -1;
+	search->nextNogood = 0;
+	search->skipped = 0;
+	return search;
+}
+
+/*
+ * destroySearch
+ *
+ *  This function frees the backjumping state of a search (a state in the arena is left to the arena)
+ */
+void destroySearch(Search* search)
+{
+	if(search->inArena)
+		return;
+	free(search->levelOf);
+	free(search->conflicts);
+	free(search->solutionBelow);
+	free(search->nogoods);
+	free(search->watchHead);
+	free(search->watchNext);
+	free(search);
+}
+
+/*
+ * addConflict
+ *
+ *  This function adds the level "culprit" to the conflict set of "level". levels which are not above
+ *  "level" (and -1, which stands for the given cells) are ignored.
+ */
+void addConflict(Search* search, int level, int culprit)
+{
+	if(culprit>=0 && culprit<level)
+		search->conflicts[level*search->words+culprit/WORDBITS] |= 1UL<<(culprit%WORDBITS);
+}
+
+/*
+ * culprit
+ *
+ *  This function finds why a value is not valid for an empty cell: the level of a cell with this value in
+ *  the cell's row, column or box (the lowest such level is taken, so the jumps are longer).
+ *  returns -1 if a given cell has the value.
+ */
+int culprit(Board* board, Search* search, int cell, int value)
+{
+	int i, kind, other, unit, level=-1, N=board->boardsize;
+	for(kind=0;kind<3;kind++)
+	{
+		unit = kind==0 ? cell/N : (kind==1 ? cell%N : BOX(board,cell/N,cell%N));
+		for(i=0;i<N;i++)
+		{
+			other=unitCell(board,kind,unit,i);
+			if(board->values[other]!=value || other==cell)
+				continue;
+			if(search->levelOf[other]==-1)
+				return -1;
+			if(level==-1 || search->levelOf[other]<level)
+				level=search->levelOf[other];
+		}
+	}
+	return level;
+}
+
+/*
+ * explainCell
+ *
+ *  This function adds to the conflict set of a level the reasons for all the values which are not valid
+ *  for an empty cell
+ */
+void explainCell(Board* board, Search* search, int level, int cell)
+{
+	int value, N=board->boardsize;
+	for(value=1;value<=N;value++)
+		if(!isValid(board,cell/N,cell%N,value))
+			addConflict(search,level,culprit(board,search,cell,value));
+}
+
+/*
+ * explainUnit
+ *
+ *  This function adds to the conflict set of a level the reasons why some value which is missing in a unit
+ *  cannot be placed in any of its cells: the levels of the unit's assigned cells, and the reasons the
+ *  value is not valid for the unit's empty cells
+ */
+void explainUnit(Board* board, Search* search, int level)
+{
+	int kind, unit, value, i, cell, places, N=board->boardsize;
+	for(kind=0;kind<3;kind++)
+		for(unit=0;unit<N;unit++)
+			for(value=1;value<=N;value++)
+			{
+				for(i=0,places=0;i<N && places==0;i++)
+				{
+					cell=unitCell(board,kind,unit,i);
+					places = board->values[cell]==value || (board->values[cell]==0 && isValid(board,cell/N,cell%N,value));
+				}
+				if(places)
+					continue;
+				for(i=0;i<N;i++)
+				{
+					cell=unitCell(board,kind,unit,i);
+					if(board->values[cell]!=0)
+						addConflict(search,level,search->levelOf[cell]);
+					else
+						addConflict(search,level,culprit(board,search,cell,value));
+				}
+				return;
+			}
+}
+
+/*
+ * backjump
+ *
+ *  This function is called when all the values of the top level failed. it adds the reasons of the values
+ *  which were not valid for the level's cell in the first place (the board is as it was when the level
+ *  was pushed), stores the level's conflict set as a nogood, and goes back to the deepest level in it
+ *  (emptying the levels in between). the rest of the conflict set moves to that level.
+ *  returns 0 if the conflict set is empty - then the search is over, and the stack is emptied.
+ */
+int backjump(Board* board, int* options, unsigned long* masks, Stack* stack, Search* search)
+{
+	int word, level=stack->length-1, target=level-1, solution=search->solutionBelow[level], words=search->words;
+	unsigned long *conflict=search->conflicts+level*words;
+
+	/* with a solution below, the conflict set is all the levels above */
+	if(!solution)
+	{
+		explainCell(board,search,level,CELL(board,top(stack)->column,top(stack)->row));
+		for(target=level-1;target>=0 && !(conflict[target/WORDBITS] & (1UL<<(target%WORDBITS)));target--);
+		recordNogood(board,search,stack,level);
+	}
+	pop(stack,NULL);
+
+	while(stack->length-1>target)
+	{
+		search->skipped++; /* the level's other values are not tried */
+		solution |= search->solutionBelow[stack->length-1];
+		removeAssignment(board,options,masks,stack);
+		pop(stack,NULL);
+	}
+	if(target==-1)
+		return 0;
+
+	if(solution)
+		search->solutionBelow[target]=1;
+	else
+	{
+		conflict[target/WORDBITS] &= ~(1UL<<(target%WORDBITS));
+		for(word=0;word<words;word++)
+			search->conflicts[target*words+word] |= conflict[word];
+	}
+	return 1;
+}
+
+/*
+ * recordNogood
+ *
+ *  This function stores the assignments of the levels in the conflict set of a level as a nogood, unless
+ *  there are too many of them. the nogood replaces the oldest one, and every one of its cells watches it.
+ */
+void recordNogood(Board* board, Search* search, Stack* stack, int level)
+{
+	int i, length=0, slot, cell, *entry;
+	Nogood *nogood;
+
+	for(i=0;i<level;i++)
+		if(search->conflicts[level*search->words+i/WORDBITS] & (1UL<<(i%WORDBITS)))
+			length++;
+	if(length==0 || length>NOGOOD_LENGTH)
+		return;
+
+	slot=search->nextNogood;
+	search->nextNogood=(slot+1)%NOGOODS_MAX;
+	nogood=&search->nogoods[slot];
+	/* the old nogood of the slot stops being watched */
+	for(i=0;i<nogood->length;i++)
+	{
+		entry=&search->watchHead[nogood->cells[i]];
+		while(*entry!=slot*NOGOOD_LENGTH+i)
+			entry=&search->watchNext[*entry];
+		*entry=search->watchNext[*entry];
+	}
+
+	nogood->length=0;
+	for(i=0;i<level;i++)
+		if(search->conflicts[level*search->words+i/WORDBITS] & (1UL<<(i%WORDBITS)))
+		{
+			cell=CELL(board,stack->nodes[i].column,stack->nodes[i].row);
+			nogood->cells[nogood->length]=cell;
+			nogood->values[nogood->length]=stack->nodes[i].value;
+			search->watchNext[slot*NOGOOD_LENGTH+nogood->length]=search->watchHead[cell];
+			search->watchHead[cell]=slot*NOGOOD_LENGTH+nogood->length;
+			nogood->length++;
+		}
+}
+
+/*
+ * checkNogoods
+ *
+ *  This function checks whether the assignment cell=value of a level completes a stored nogood. if so,
+ *  the levels of the nogood's other assignments are added to the level's conflict set.
+ *  returns 1 if a nogood was completed, 0 otherwise.
+ */
+int checkNogoods(Board* board, Search* search, int cell, int value, int level)
+{
+	int entry, i;
+	Nogood *nogood;
+	for(entry=search->watchHead[cell];entry!=-1;entry=search->watchNext[entry])
+	{
+		nogood=&search->nogoods[entry/NOGOOD_LENGTH];
+		if(nogood->values[entry%NOGOOD_LENGTH]!=value)
+			continue;
+		for(i=0;i<nogood->length && board->values[nogood->cells[i]]==nogood->values[i];i++);
+		if(i<nogood->length)
+			continue;
+		for(i=0;i<nogood->length;i++)
+			addConflict(search,level,search->levelOf[nogood->cells[i]]);
+		search->skipped++;
+		return 1;
+	}
+	return 0;
+}
+
+/* End of private methods */
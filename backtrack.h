@@ -0,0 +1,80 @@
+/*
+ * Backtrack Module
+ *
+ *  This module solves and counts sudoku boards by an iterative backtracking, which simulates the recursion
+ *  with a stack. Every level deals with the empty cell which has the fewest options (or with the cell of a
+ *  hidden single), and the options counters are kept updated on every assignment (and restored from the
+ *  stack's trail on backtrack).
+ *  The search is conflict-directed: every level keeps the levels whose assignments made its values fail,
+ *  and when all the values failed the search jumps straight back to the deepest of them. These conflicts
+ *  are also kept as nogoods, which cut the same failure when it shows up again in another branch.
+ */
+
+#ifndef BACKTRACK_H_
+#define BACKTRACK_H_
+
+#include "game.h"
+
+/*
+ * backtrackSolve
+ *
+ *  This function finds a solution of the board and fills the board's empty cells with it.
+ *  the board is not changed if there is no solution.
+ *  @param board - the board to solve
+ *  @return - 1 if solved, 0 if the board is unsolvable
+ */
+int backtrackSolve(Board *board);
+
+/*
+ * backtrackCount
+ *
+ *  This function counts the solutions of the board, with the counting threads if there is no limit.
+ *  the board is not changed.
+ *  @param board - the board
+ *  @param limit - stop counting after that many solutions (0 = count them all)
+ *  @return - number of solutions (at most limit)
+ */
+unsigned long backtrackCount(Board *board, unsigned long limit);
+
+/*
+ * backtrackEnumerate
+ *
+ *  This function goes over all the solutions of the board. for each solution the board's empty cells
+ *  are filled with it and the callback is called. after the callback the cells are emptied again.
+ *  @param board - the board
+ *  @param onSolution - called for every solution, returns 0 in order to stop the enumeration
+ *  @param data - passed to the callback
+ *  @return - number of solutions visited
+ */
+unsigned long backtrackEnumerate(Board *board, int (*onSolution)(Board *board, void *data), void *data);
+
+/*
+ * backtrackNodesCount
+ *
+ *  This function returns the number of search nodes of the last backtracking run
+ *  @return - number of nodes
+ */
+unsigned long backtrackNodesCount();
+
+/*
+ * backtrackSkippedCount
+ *
+ *  This function returns the number of nodes the last backtracking run skipped: the levels it jumped over
+ *  and the assignments which nogoods cut
+ *  @return - number of skipped nodes
+ */
+unsigned long backtrackSkippedCount();
+
+/*
+ * countSolutions
+ *
+ *  This function counts the solutions of a board which has no errors. the board is given back unchanged.
+ *  the function uses no shared state, so threads may call it on their own boards.
+ *
+ *  @param board - the board (can be a copy of the game board)
+ *  @param nodes - pointer to a counter of search nodes, increased by the nodes this search visits
+ *  @return - number of possible solutions
+ */
+unsigned long countSolutions(Board* board, unsigned long* nodes);
+
+#endif /* BACKTRACK_H_ */
@@ -0,0 +1,514 @@
+/*
+ * Classic Board Module
+ *
+ *  This module is a dedicated engine for the classic 9x9 board (3x3 boxes), which is most of the boards
+ *  the game gets. The generic code works on any n,m and divides on every access, this module works on
+ *  fixed size arrays and on tables which are computed once: the peers of every cell and the cells of
+ *  every row, column and box.
+ *  The candidates are bitboards - for every digit, the 81 cells where it can still be placed, kept in three
+ *  bands of 27 bits (a band is three rows, so every row and box is inside one band).
+ *  validate, hint, autofill and num_solutions use this module by themselves for 9x9 boards. Counting all the
+ *  solutions is split between the counting threads, like the backtracking engine's.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "game.h"
+#include "mainAux.h"
+#include "classic.h"
+#include "parallel.h"
+#include "arena.h"
+
+#define CLASSIC_SIZE 9
+#define CLASSIC_CELLS 81
+#define CLASSIC_UNITS 27 /* 9 rows, 9 columns and 9 boxes */
+#define BANDS 3
+#define BAND_CELLS 27
+#define FULL_BAND ((1UL<<BAND_CELLS)-1)
+#define ALL_DIGITS 0x1FF
+
+/* the band of a cell, and the cell's bit in the band */
+#define CELL_BAND(cell) ((cell)/BAND_CELLS)
+#define CELL_BIT(cell) (1UL<<((cell)%BAND_CELLS))
+
+/* A set of cells: bit i of band b is cell b*27+i */
+typedef struct bitboard {
+	unsigned long band[BANDS];
+} Bitboard;
+
+/* The state of the search: the candidates of every digit and the cells' values */
+typedef struct grid {
+	Bitboard digits[CLASSIC_SIZE]; /* the cells where the digit can be placed (its filled cells included) */
+	Bitboard filled;
+	char values[CLASSIC_CELLS];
+} Grid;
+
+static int tablesReady = 0;
+static Bitboard peers[CLASSIC_CELLS]; /* the cells which share a row, column or box with the cell */
+static Bitboard units[CLASSIC_UNITS];
+static int cellUnits[CLASSIC_CELLS][3]; /* the cell's row, column (9+) and box (18+) */
+static int unitBands[CLASSIC_UNITS][2]; /* the first and the last band of the unit's cells */
+static unsigned long nodesCount = 0; /* search nodes of the last run */
+
+/* private methods declaration: */
+void initClassicTables();
+unsigned long searchClassic(Board *board, unsigned long limit, int keepSolution, unsigned long *nodes, int inArena);
+int loadGrid(Board *board, Grid *grid);
+void placeDigit(Grid *grid, int cell, int digit);
+int classicCandidates(Grid *grid, int cell);
+void countCandidates(Grid *grid, Bitboard *once, Bitboard *twice, Bitboard *thrice);
+int propagateGrid(Grid *grid, Bitboard *pairs);
+int unitSingle(Grid *grid, int digit, int unit);
+int lowestBit(unsigned long word);
+int chooseClassicCell(Grid *grid, Bitboard *pairs);
+
+/* Public methods: */
+
+/*
+ * isClassic
+ *
+ *  This function checks whether the board is a classic 9x9 board with 3x3 boxes
+ *  @param board - the game board
+ *  @return - 1 if the board is classic, 0 otherwise
+ */
+int isClassic(Board *board)
+{
+	return board->n==3 && board->m==3;
+}
+
+/*
+ * classicSolve
+ *
+ *  This function finds a solution of a classic board and fills the board's empty cells with it.
+ *  the board is not changed if there is no solution.
+ *  @param board - the board to solve (9x9)
+ *  @return - 1 if solved, 0 if the board is unsolvable
+ */
+int classicSolve(Board *board)
+{
+	initClassicTables();
+	nodesCount = 0;
+	return searchClassic(board, 1, 1, &nodesCount, 1)==1;
+}
+
+/*
+ * classicCount
+ *
+ *  This function counts the solutions of a classic board, with the counting threads if there is no limit.
+ *  the board is not changed.
+ *  @param board - the board (9x9)
+ *  @param limit - stop counting after that many solutions (0 = count them all)
+ *  @return - number of solutions (at most limit)
+ */
+unsigned long classicCount(Board *board, unsigned long limit)
+{
+	Grid grid;
+	initClassicTables();
+	nodesCount = 0;
+	/* split the search between threads if more than one thread was asked for */
+	if (limit==0 && getCountingThreads()>1)
+		return loadGrid(board, &grid) ? parallelCount(board, classicCountSolutions, &nodesCount) : 0;
+	return searchClassic(board, limit, 0, &nodesCount, 1);
+}
+
+/*
+ * classicCountSolutions
+ *
+ *  This function counts all the solutions of a classic board in the calling thread - the counter of the
+ *  counting threads' tasks. it keeps no global state (the tables are computed by classicCount before the
+ *  threads start), so the threads can run it together. the board is not changed.
+ *  @param board - the board (9x9)
+ *  @param nodes - pointer to a counter of search nodes, increased by the nodes of this count
+ *  @return - number of solutions
+ */
+unsigned long classicCountSolutions(Board *board, unsigned long *nodes)
+{
+	return searchClassic(board, 0, 0, nodes, 0);
+}
+
+/*
+ * classicNodesCount
+ *
+ *  This function returns the number of search nodes of the last classic run
+ *  @return - number of nodes
+ */
+unsigned long classicNodesCount()
+{
+	return nodesCount;
+}
+
+/*
+ * classicSingles
+ *
+ *  This function finds the naked singles of a classic board: the empty cells which have only one
+ *  valid value
+ *  @param board - the board (9x9)
+ *  @param singles - array of 81 entries, gets the only valid value of every cell (0 if the cell is filled,
+ *                   or has no valid value or more than one)
+ *  @return -
+ */
+void classicSingles(Board *board, int *singles)
+{
+	int cell, freeDigits, digit, used[CLASSIC_UNITS]={0};
+
+	initClassicTables();
+	/* the digits which are used in every unit, as 9 bits masks */
+	for (cell=0; cell<CLASSIC_CELLS; cell++)
+		if (board->values[cell]!=0)
+		{
+			used[cellUnits[cell][0]] |= 1<<(board->values[cell]-1);
+			used[cellUnits[cell][1]] |= 1<<(board->values[cell]-1);
+			used[cellUnits[cell][2]] |= 1<<(board->values[cell]-1);
+		}
+	for (cell=0; cell<CLASSIC_CELLS; cell++)
+	{
+		singles[cell] = 0;
+		freeDigits = ALL_DIGITS & ~(used[cellUnits[cell][0]] | used[cellUnits[cell][1]] | used[cellUnits[cell][2]]);
+		if (board->values[cell]!=0 || freeDigits==0 || (freeDigits & (freeDigits-1))!=0)
+			continue;
+		for (digit=0; !(freeDigits & (1<<digit)); digit++);
+		singles[cell] = digit+1;
+	}
+}
+
+/* End of public methods */
+
+/* Private methods: */
+
+/*
+ * initClassicTables
+ *
+ *  This function computes the units and peers tables, on the first call only
+ */
+void initClassicTables()
+{
+	int cell, other, unit, row, column, box;
+	if (tablesReady)
+		return;
+	for (cell=0; cell<CLASSIC_CELLS; cell++)
+	{
+		row = cell/CLASSIC_SIZE;
+		column = cell%CLASSIC_SIZE;
+		box = (row/3)*3 + column/3;
+		cellUnits[cell][0] = row;
+		cellUnits[cell][1] = CLASSIC_SIZE+column;
+		cellUnits[cell][2] = 2*CLASSIC_SIZE+box;
+		for (unit=0; unit<3; unit++)
+			units[cellUnits[cell][unit]].band[CELL_BAND(cell)] |= CELL_BIT(cell);
+	}
+	for (unit=0; unit<CLASSIC_SIZE; unit++)
+	{
+		/* a row and a box are in one band, a column crosses all of them */
+		unitBands[unit][0] = unitBands[unit][1] = unit/3;
+		unitBands[CLASSIC_SIZE+unit][0] = 0;
+		unitBands[CLASSIC_SIZE+unit][1] = BANDS-1;
+		unitBands[2*CLASSIC_SIZE+unit][0] = unitBands[2*CLASSIC_SIZE+unit][1] = unit/3;
+	}
+	for (cell=0; cell<CLASSIC_CELLS; cell++)
+		for (other=0; other<CLASSIC_CELLS; other++)
+			if (other!=cell && (cellUnits[cell][0]==cellUnits[other][0] || cellUnits[cell][1]==cellUnits[other][1]
+					|| cellUnits[cell][2]==cellUnits[other][2]))
+				peers[cell].band[CELL_BAND(other)] |= CELL_BIT(other);
+	tablesReady = 1;
+}
+
+/*
+ * searchClassic
+ *
+ *  This function goes over the solutions of a classic board by an iterative backtracking on an array of
+ *  grids: the grid of every level is a copy of the previous one with one more digit, and the singles
+ *  it forces. going back a level costs nothing. every level deals with the empty cell which has the
+ *  fewest candidates.
+ *  limit - stop after that many solutions (0 = never). keepSolution - if the search stops on a solution,
+ *  the board's empty cells are filled with it. otherwise the board is not changed. the search nodes are added
+ *  to *nodes. the tables have to be computed before. inArena - 1 on the main thread: the grids are taken
+ *  from the arena (the counting threads allocate them by themselves).
+ *  returns the number of found solutions.
+ */
+unsigned long searchClassic(Board *board, unsigned long limit, int keepSolution, unsigned long *nodes, int inArena)
+{
+	int level=0, cell, digit, solvedLevel=-1, cells[CLASSIC_CELLS+1], untried[CLASSIC_CELLS+1];
+	unsigned long count=0;
+	size_t mark = inArena ? arenaMark() : 0;
+	Grid *grids;
+	Bitboard pairs;
+
+	grids = inArena ? arenaAlloc((CLASSIC_CELLS+1)*sizeof(Grid)) : malloc((CLASSIC_CELLS+1)*sizeof(Grid));
+	if (!grids)
+	{
+		printf("Error: malloc has failed\n");
+		exit(0);
+	}
+
+	if (!loadGrid(board, &grids[0]) || !propagateGrid(&grids[0], &pairs))
+		level = -1;
+	else if ((cells[0] = chooseClassicCell(&grids[0], &pairs))==-1)
+	{
+		count = 1;
+		solvedLevel = 0;
+		level = -1;
+	}
+	else
+		untried[0] = classicCandidates(&grids[0], cells[0]);
+
+	while (level>=0)
+	{
+		if (untried[level]==0) /* all the digits of the level's cell were tried */
+		{
+			level--;
+			continue;
+		}
+		for (digit=0; !(untried[level] & (1<<digit)); digit++);
+		untried[level] &= ~(1<<digit);
+		(*nodes)++;
+		grids[level+1] = grids[level];
+		placeDigit(&grids[level+1], cells[level], digit);
+		if (!propagateGrid(&grids[level+1], &pairs))
+			continue;
+		cell = chooseClassicCell(&grids[level+1], &pairs);
+		if (cell==-1) /* the grid is full */
+		{
+			count++;
+			if (limit!=0 && count>=limit)
+			{
+				solvedLevel = level+1;
+				break;
+			}
+			continue;
+		}
+		level++;
+		cells[level] = cell;
+		untried[level] = classicCandidates(&grids[level], cell);
+	}
+
+	if (keepSolution && solvedLevel!=-1)
+		for (cell=0; cell<CLASSIC_CELLS; cell++)
+			if (board->values[cell]==0)
+				setCellValue(board, cell/CLASSIC_SIZE, cell%CLASSIC_SIZE, grids[solvedLevel].values[cell]);
+	if (inArena)
+		arenaRewind(mark);
+	else
+		free(grids);
+	return count;
+}
+
+/*
+ * loadGrid
+ *
+ *  This function builds the grid of a board: every digit can be placed everywhere, and then the board's
+ *  filled cells are placed. returns 0 if two filled cells collide, 1 otherwise.
+ */
+int loadGrid(Board *board, Grid *grid)
+{
+	int cell, digit, band;
+	for (digit=0; digit<CLASSIC_SIZE; digit++)
+		for (band=0; band<BANDS; band++)
+			grid->digits[digit].band[band] = FULL_BAND;
+	for (band=0; band<BANDS; band++)
+		grid->filled.band[band] = 0;
+	for (cell=0; cell<CLASSIC_CELLS; cell++)
+	{
+		grid->values[cell] = 0;
+		if (board->values[cell]==0)
+			continue;
+		digit = board->values[cell]-1;
+		if (!(grid->digits[digit].band[CELL_BAND(cell)] & CELL_BIT(cell)))
+			return 0;
+		placeDigit(grid, cell, digit);
+	}
+	return 1;
+}
+
+/*
+ * placeDigit
+ *
+ *  This function fills a cell with a digit (0..8): the digit is removed from the cell's peers, and the
+ *  other digits from the cell
+ */
+void placeDigit(Grid *grid, int cell, int digit)
+{
+	int other, band=CELL_BAND(cell);
+	unsigned long bit=CELL_BIT(cell);
+
+	grid->values[cell] = (char)(digit+1);
+	grid->filled.band[band] |= bit;
+	for (other=0; other<CLASSIC_SIZE; other++)
+		grid->digits[other].band[band] &= ~bit;
+	grid->digits[digit].band[0] &= ~peers[cell].band[0];
+	grid->digits[digit].band[1] &= ~peers[cell].band[1];
+	grid->digits[digit].band[2] &= ~peers[cell].band[2];
+	grid->digits[digit].band[band] |= bit;
+}
+
+/*
+ * classicCandidates
+ *
+ *  This function returns the digits which can be placed in a cell, as a 9 bits mask (bit digit)
+ */
+int classicCandidates(Grid *grid, int cell)
+{
+	int digit, band=CELL_BAND(cell), shift=cell%BAND_CELLS, candidates=0;
+	for (digit=0; digit<CLASSIC_SIZE; digit++)
+		candidates |= (int)((grid->digits[digit].band[band] >> shift) & 1UL) << digit;
+	return candidates;
+}
+
+/*
+ * countCandidates
+ *
+ *  This function counts the candidates of all the cells at once, as a bit sliced counter which stops at
+ *  three: the cells which have at least one, at least two and at least three candidates (a filled cell
+ *  has one - its digit)
+ */
+void countCandidates(Grid *grid, Bitboard *once, Bitboard *twice, Bitboard *thrice)
+{
+	int digit, band;
+	unsigned long cells, one, two, three;
+	for (band=0; band<BANDS; band++)
+	{
+		one = two = three = 0;
+		for (digit=0; digit<CLASSIC_SIZE; digit++)
+		{
+			cells = grid->digits[digit].band[band];
+			three |= two & cells;
+			two |= one & cells;
+			one |= cells;
+		}
+		once->band[band] = one;
+		twice->band[band] = two;
+		thrice->band[band] = three;
+	}
+}
+
+/*
+ * propagateGrid
+ *
+ *  This function fills the naked singles (a cell which has one digit) and the hidden singles (a digit
+ *  which has one cell in a unit) of the grid, until there are none left. the naked singles of all the
+ *  cells are found together by countCandidates, and the hidden ones only when there are no naked ones.
+ *  pairs - gets the empty cells which are left with two candidates.
+ *  returns 0 if some empty cell has no digit, or some digit has no cell in a unit, 1 otherwise.
+ */
+int propagateGrid(Grid *grid, Bitboard *pairs)
+{
+	int band, digit, unit, cell, changed=1;
+	unsigned long singles;
+	Bitboard once, twice, thrice;
+
+	while (changed)
+	{
+		changed = 0;
+		countCandidates(grid, &once, &twice, &thrice);
+		for (band=0; band<BANDS; band++)
+		{
+			if (once.band[band]!=FULL_BAND) /* some empty cell has no candidate */
+				return 0;
+			singles = once.band[band] & ~twice.band[band] & ~grid->filled.band[band];
+			pairs->band[band] = twice.band[band] & ~thrice.band[band] & ~grid->filled.band[band];
+			for (; singles!=0; singles &= singles-1)
+			{
+				cell = band*BAND_CELLS + lowestBit(singles);
+				/* a single which was placed before may have taken the cell's only digit */
+				for (digit=0; digit<CLASSIC_SIZE && !(grid->digits[digit].band[band] & CELL_BIT(cell)); digit++);
+				if (digit==CLASSIC_SIZE)
+					return 0;
+				placeDigit(grid, cell, digit);
+				changed = 1;
+			}
+		}
+		if (changed)
+			continue;
+		for (digit=0; digit<CLASSIC_SIZE; digit++)
+		{
+			/* a digit which is in all the units already has no hidden singles (if it is missing somewhere,
+			 * some cell of that unit will be left with no candidate) */
+			if (((grid->digits[digit].band[0] & ~grid->filled.band[0]) | (grid->digits[digit].band[1]
+					& ~grid->filled.band[1]) | (grid->digits[digit].band[2] & ~grid->filled.band[2]))==0)
+				continue;
+			for (unit=0; unit<CLASSIC_UNITS; unit++)
+			{
+				cell = unitSingle(grid, digit, unit);
+				if (cell==-2) /* the digit has no place in the unit */
+					return 0;
+				if (cell>=0)
+				{
+					placeDigit(grid, cell, digit);
+					changed = 1;
+				}
+			}
+		}
+	}
+	return 1;
+}
+
+/*
+ * unitSingle
+ *
+ *  This function finds the cells of a unit where a digit can be placed. a row or a box is inside one
+ *  band, so only a column needs all the three bands.
+ *  returns the cell if it is the only one and it is empty, -2 if there is none, -1 otherwise.
+ */
+int unitSingle(Grid *grid, int digit, int unit)
+{
+	int band, found=-2;
+	unsigned long cells;
+	for (band=unitBands[unit][0]; band<=unitBands[unit][1]; band++)
+	{
+		cells = grid->digits[digit].band[band] & units[unit].band[band];
+		if (cells==0)
+			continue;
+		if (found!=-2 || (cells & (cells-1))!=0 || (cells & grid->filled.band[band])!=0)
+			return -1;
+		found = band;
+	}
+	if (found>=0)
+		found = found*BAND_CELLS + lowestBit(grid->digits[digit].band[found] & units[unit].band[found]);
+	return found;
+}
+
+/*
+ * lowestBit
+ *
+ *  This function returns the index of the lowest set bit of a band (which is not 0): the bit alone has a
+ *  different remainder modulo 37 for each of the 27 places
+ */
+int lowestBit(unsigned long word)
+{
+	static const int bitOfRemainder[37] = {
+		-1, 0, 1, 26, 2, 23, -1, -1, 3, 16, 24, -1, -1, 11, -1, 13, 4, 7, 17,
+		-1, 25, 22, -1, 15, -1, 10, 12, 6, -1, 21, 14, 9, 5, 20, 8, 19, 18
+	};
+	return bitOfRemainder[(word & (~word+1)) % 37];
+}
+
+/*
+ * chooseClassicCell
+ *
+ *  This function returns the empty cell with the fewest candidates, -1 if the grid is full. a cell with
+ *  two candidates (from the pairs which propagateGrid found) is the best one after the propagation, and
+ *  it is taken without a scan.
+ */
+int chooseClassicCell(Grid *grid, Bitboard *pairs)
+{
+	int band, cell, count, candidates, best=-1, bestCount=CLASSIC_SIZE+1;
+
+	for (band=0; band<BANDS; band++)
+		if (pairs->band[band]!=0)
+			return band*BAND_CELLS + lowestBit(pairs->band[band]);
+	for (cell=0; cell<CLASSIC_CELLS; cell++)
+	{
+		if (grid->values[cell]!=0)
+			continue;
+		candidates = classicCandidates(grid, cell);
+		for (count=0; candidates!=0; count++)
+			candidates &= candidates-1;
+		if (count<bestCount)
+		{
+			best = cell;
+			bestCount = count;
+		}
+	}
+	return best;
+}
+
+/* End of private methods */
@@ -0,0 +1,81 @@
+/*
+ * Classic Board Module
+ *
+ *  This module is a dedicated engine for the classic 9x9 board (3x3 boxes), which is most of the boards
+ *  the game gets. The generic code works on any n,m and divides on every access, this module works on
+ *  fixed size arrays and on tables which are computed once: the peers of every cell and the cells of
+ *  every row, column and box.
+ *  The candidates are bitboards - for every digit, the 81 cells where it can still be placed, kept in three
+ *  bands of 27 bits (a band is three rows, so every row and box is inside one band).
+ *  validate, hint, autofill and num_solutions use this module by themselves for 9x9 boards. Counting all the
+ *  solutions is split between the counting threads, like the backtracking engine's.
+ */
+
+#ifndef CLASSIC_H_
+#define CLASSIC_H_
+
+#include "game.h"
+
+/*
+ * isClassic
+ *
+ *  This function checks whether the board is a classic 9x9 board with 3x3 boxes
+ *  @param board - the game board
+ *  @return - 1 if the board is classic, 0 otherwise
+ */
+int isClassic(Board *board);
+
+/*
+ * classicSolve
+ *
+ *  This function finds a solution of a classic board and fills the board's empty cells with it.
+ *  the board is not changed if there is no solution.
+ *  @param board - the board to solve (9x9)
+ *  @return - 1 if solved, 0 if the board is unsolvable
+ */
+int classicSolve(Board *board);
+
+/*
+ * classicCount
+ *
+ *  This function counts the solutions of a classic board, with the counting threads if there is no limit.
+ *  the board is not changed.
+ *  @param board - the board (9x9)
+ *  @param limit - stop counting after that many solutions (0 = count them all)
+ *  @return - number of solutions (at most limit)
+ */
+unsigned long classicCount(Board *board, unsigned long limit);
+
+/*
+ * classicCountSolutions
+ *
+ *  This function counts all the solutions of a classic board in the calling thread - the counter of the
+ *  counting threads' tasks. it keeps no global state (the tables are computed by classicCount before the
+ *  threads start), so the threads can run it together. the board is not changed.
+ *  @param board - the board (9x9)
+ *  @param nodes - pointer to a counter of search nodes, increased by the nodes of this count
+ *  @return - number of solutions
+ */
+unsigned long classicCountSolutions(Board *board, unsigned long *nodes);
+
+/*
+ * classicNodesCount
+ *
+ *  This function returns the number of search nodes of the last classic run
+ *  @return - number of nodes
+ */
+unsigned long classicNodesCount();
+
+/*
+ * classicSingles
+ *
+ *  This function finds the naked singles of a classic board: the empty cells which have only one
+ *  valid value
+ *  @param board - the board (9x9)
+ *  @param singles - array of 81 entries, gets the only valid value of every cell (0 if the cell is filled,
+ *                   or has no valid value or more than one)
+ *  @return -
+ */
+void classicSingles(Board *board, int *singles);
+
+#endif /* CLASSIC_H_ */
@@ -0,0 +1,396 @@
+/*
+ * DLX Module
+ *
+ *  This module solves a sudoku board as an exact cover problem, using Knuth's Algorithm X
+ *  with dancing links. Every (cell,value) option is a row of the cover matrix, and the columns are
+ *  the constraints: each cell has one value, and each row, column and box has each value once.
+ *  The module can find one solution, count the solutions or go over all of them.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "game.h"
+#include "solver.h"
+#include "mainAux.h"
+#include "arena.h"
+#include "dlx.h"
+
+/* The dancing links structure: all the nodes are kept in arrays and linked by their indexes.
+ * node 0 is the root, nodes 1..columnsNum are the column headers and the rest are the options' nodes */
+typedef struct dlx {
+	int *left;
+	int *right;
+	int *up;
+	int *down;
+	int *column; /* the header of the node's column (a header points to itself) */
+	int *size; /* number of nodes in a column (relevant to headers only) */
+	int *option; /* the option of a node: cell*boardsize + value-1 */
+	int *choice; /* the chosen node in each search level */
+	int nodesNum;
+	int columnsNum;
+	size_t mark; /* the arena's top before buildDlx - destroyDlx rewinds the arena to it */
+} Dlx;
+
+static unsigned long nodesCount = 0; /* search nodes of the last run */
+
+/* private methods declaration: */
+Dlx* buildDlx(Board *board);
+void destroyDlx(Dlx *dlx);
+void coverColumn(Dlx *dlx, int header);
+void uncoverColumn(Dlx *dlx, int header);
+int chooseColumn(Dlx *dlx);
+unsigned long searchDlx(Dlx *dlx, Board *board, unsigned long stopAt, int keepSolution, int (*onSolution)(Board *board, void *data), void *data);
+void writeSolution(Dlx *dlx, Board *board, int levels, int value);
+
+/* Public methods: */
+
+/*
+ * dlxSolve
+ *
+ *  This function finds a solution of the board and fills the board's empty cells with it.
+ *  the board is not changed if there is no solution.
+ *  @param board - the board to solve
+ *  @return - 1 if solved, 0 if the board is unsolvable
+ */
+int dlxSolve(Board *board)
+{
+	int found;
+	Dlx *dlx = buildDlx(board);
+	nodesCount = 0;
+	if (!dlx) /* the given values already break the constraints */
+		return 0;
+	found = searchDlx(dlx, board, 1, 1, NULL, NULL);
+	destroyDlx(dlx);
+	return found;
+}
+
+/*
+ * dlxCount
+ *
+ *  This function counts the solutions of the board. the board is not changed.
+ *  @param board - the board
+ *  @param limit - stop counting after that many solutions (0 = count them all)
+ *  @return - number of solutions (at most limit)
+ */
+unsigned long dlxCount(Board *board, unsigned long limit)
+{
+	unsigned long count;
+	Dlx *dlx = buildDlx(board);
+	nodesCount = 0;
+	if (!dlx)
+		return 0;
+	count = searchDlx(dlx, board, limit, 0, NULL, NULL);
+	destroyDlx(dlx);
+	return count;
+}
+
+/*
+ * dlxEnumerate
+ *
+ *  This function goes over all the solutions of the board. for each solution the board's empty cells
+ *  are filled with it and the callback is called. after the callback the cells are emptied again.
+ *  @param board - the board
+ *  @param onSolution - called for every solution, returns 0 in order to stop the enumeration
+ *  @param data - passed to the callback
+ *  @return - number of solutions visited
+ */
+unsigned long dlxEnumerate(Board *board, int (*onSolution)(Board *board, void *data), void *data)
+{
+	unsigned long count;
+	Dlx *dlx = buildDlx(board);
+	nodesCount = 0;
+	if (!dlx)
+		return 0;
+	count = searchDlx(dlx, board, 0, 0, onSolution, data);
+	destroyDlx(dlx);
+	return count;
+}
+
+/*
+ * dlxNodesCount
+ *
+ *  This function returns the number of search nodes of the last dlx run
+ *  @return - number of nodes
+ */
+unsigned long dlxNodesCount()
+{
+	return nodesCount;
+}
+
+/* End of public methods */
+
+/* Private methods: */
+
+/*
+ * buildDlx
+ *
+ *  This function builds the cover matrix of the board. the constraints which are already satisfied by
+ *  the filled cells are left out, and so are the options that collide with the filled cells.
+ *  the matrix is in the command's arena. returns NULL if two filled cells collide (the board has no solution).
+ */
+Dlx* buildDlx(Board *board)
+{
+	int N, cellsNum, row, column, value, cell, optionsNum=0, i, node, header, first;
+	int constraints[4];
+	char *covered;
+	Dlx *dlx;
+	size_t mark = arenaMark();
+
+	N = board->boardsize;
+	cellsNum = N*N;
+
+	/* the constraints the filled cells already cover */
+	covered = memset(arenaAlloc(4*cellsNum), 0, 4*cellsNum);
+	for (row=0; row<N; row++)
+		for (column=0; column<N; column++)
+		{
+			value = board->values[CELL(board,row,column)];
+			if (value==0)
+			{
+				/* count the options of the empty cell */
+				for (value=1; value<=N; value++)
+					optionsNum += isValid(board,row,column,value);
+				continue;
+			}
+			constraints[0] = CELL(board,row,column);
+			constraints[1] = cellsNum + row*N + value-1;
+			constraints[2] = 2*cellsNum + column*N + value-1;
+			constraints[3] = 3*cellsNum + BOX(board,row,column)*N + value-1;
+			for (i=0; i<4; i++)
+			{
+				if (covered[constraints[i]])
+				{
+					arenaRewind(mark);
+					return NULL;
+				}
+				covered[constraints[i]] = 1;
+			}
+		}
+
+	dlx = arenaAlloc(sizeof(Dlx));
+	dlx->mark = mark;
+	dlx->columnsNum = 4*cellsNum;
+	dlx->nodesNum = 1 + dlx->columnsNum + 4*optionsNum;
+	dlx->left = arenaAlloc(7*dlx->nodesNum*sizeof(int));
+	dlx->choice = arenaAlloc((cellsNum+1)*sizeof(int));
+	dlx->right = dlx->left + dlx->nodesNum;
+	dlx->up = dlx->right + dlx->nodesNum;
+	dlx->down = dlx->up + dlx->nodesNum;
+	dlx->column = dlx->down + dlx->nodesNum;
+	dlx->size = dlx->column + dlx->nodesNum;
+	dlx->option = dlx->size + dlx->nodesNum;
+
+	/* the root and the headers: only the uncovered constraints are linked to the root */
+	dlx->left[0] = dlx->right[0] = 0;
+	for (header=1; header<=dlx->columnsNum; header++)
+	{
+		dlx->up[header] = dlx->down[header] = dlx->column[header] = header;
+		dlx->size[header] = 0;
+		dlx->left[header] = dlx->right[header] = header;
+		if (!covered[header-1])
+		{
+			dlx->left[header] = dlx->left[0];
+			dlx->right[header] = 0;
+			dlx->right[dlx->left[0]] = header;
+			dlx->left[0] = header;
+		}
+	}
+
+	/* the options: 4 nodes for each valid value of each empty cell */
+	node = dlx->columnsNum + 1;
+	for (row=0; row<N; row++)
+		for (column=0; column<N; column++)
+		{
+			if (board->values[CELL(board,row,column)]!=0)
+				continue;
+			cell = CELL(board,row,column);
+			for (value=1; value<=N; value++)
+			{
+				if (!isValid(board,row,column,value))
+					continue;
+				constraints[0] = cell;
+				constraints[1] = cellsNum + row*N + value-1;
+				constraints[2] = 2*cellsNum + column*N + value-1;
+				constraints[3] = 3*cellsNum + BOX(board,row,column)*N + value-1;
+				first = node;
+				for (i=0; i<4; i++, node++)
+				{
+					header = constraints[i]+1;
+					dlx->column[node] = header;
+					dlx->option[node] = cell*N + value-1;
+					/* add the node at the bottom of its column */
+					dlx->up[node] = dlx->up[header];
+					dlx->down[node] = header;
+					dlx->down[dlx->up[header]] = node;
+					dlx->up[header] = node;
+					dlx->size[header]++;
+					/* and at the end of its option's row */
+					dlx->left[node] = (i==0) ? node : node-1;
+					dlx->right[node] = first;
+					dlx->right[dlx->left[node]] = node;
+					dlx->left[first] = node;
+				}
+			}
+		}
+	return dlx;
+}
+
+/*
+ * destroyDlx
+ *
+ *  This function gives the memory of the cover matrix back to the arena
+ */
+void destroyDlx(Dlx *dlx)
+{
+	arenaRewind(dlx->mark);
+}
+
+/*
+ * coverColumn
+ *
+ *  This function removes a column from the headers list, and all the options which use it from the
+ *  other columns.
+ */
+void coverColumn(Dlx *dlx, int header)
+{
+	int i,j;
+	dlx->right[dlx->left[header]] = dlx->right[header];
+	dlx->left[dlx->right[header]] = dlx->left[header];
+	for (i=dlx->down[header]; i!=header; i=dlx->down[i])
+		for (j=dlx->right[i]; j!=i; j=dlx->right[j])
+		{
+			dlx->down[dlx->up[j]] = dlx->down[j];
+			dlx->up[dlx->down[j]] = dlx->up[j];
+			dlx->size[dlx->column[j]]--;
+		}
+}
+
+/*
+ * uncoverColumn
+ *
+ *  This function undoes coverColumn - in the exact opposite order
+ */
+void uncoverColumn(Dlx *dlx, int header)
+{
+	int i,j;
+	for (i=dlx->up[header]; i!=header; i=dlx->up[i])
+		for (j=dlx->left[i]; j!=i; j=dlx->left[j])
+		{
+			dlx->size[dlx->column[j]]++;
+			dlx->down[dlx->up[j]] = j;
+			dlx->up[dlx->down[j]] = j;
+		}
+	dlx->right[dlx->left[header]] = header;
+	dlx->left[dlx->right[header]] = header;
+}
+
+/*
+ * chooseColumn
+ *
+ *  This function chooses the uncovered column with the fewest options (Knuth's S heuristic)
+ */
+int chooseColumn(Dlx *dlx)
+{
+	int header, best=0, bestSize=-1;
+	for (header=dlx->right[0]; header!=0; header=dlx->right[header])
+	{
+		if (bestSize==-1 || dlx->size[header]<bestSize)
+		{
+			best = header;
+			bestSize = dlx->size[header];
+			if (bestSize<=1)
+				break;
+		}
+	}
+	return best;
+}
+
+/*
+ * searchDlx
+ *
+ *  This function runs Algorithm X iteratively. choice[level] holds the option node tried in every level,
+ *  and when it gets back to its column header the level is exhausted.
+ *  stopAt - stop after that many solutions (0 = never). keepSolution - if it stops after a solution, the
+ *  solution stays written in the board. otherwise every found solution is written to the board only for
+ *  the callback (if there is one).
+ *  returns the number of found solutions.
+ */
+unsigned long searchDlx(Dlx *dlx, Board *board, unsigned long stopAt, int keepSolution, int (*onSolution)(Board *board, void *data), void *data)
+{
+	unsigned long count=0;
+	int level=0, descend=1, header, node, j;
+
+	while (1)
+	{
+		if (descend)
+		{
+			nodesCount++;
+			if (dlx->right[0]==0) /* every constraint is covered - a solution */
+			{
+				count++;
+				if (stopAt!=0 && count>=stopAt)
+				{
+					if (keepSolution)
+						writeSolution(dlx, board, level, 1);
+					break;
+				}
+				if (onSolution)
+				{
+					writeSolution(dlx, board, level, 1);
+					j = onSolution(board, data);
+					writeSolution(dlx, board, level, 0);
+					if (!j)
+						break;
+				}
+				descend = 0;
+				continue;
+			}
+			header = chooseColumn(dlx);
+			coverColumn(dlx, header);
+			dlx->choice[level] = dlx->down[header];
+		}
+		else
+		{
+			/* go back one level: undo the last option and move to the next one in its column */
+			if (level==0)
+				break;
+			level--;
+			node = dlx->choice[level];
+			for (j=dlx->left[node]; j!=node; j=dlx->left[j])
+				uncoverColumn(dlx, dlx->column[j]);
+			dlx->choice[level] = dlx->down[node];
+		}
+
+		node = dlx->choice[level];
+		if (node==dlx->column[node]) /* all the options of the column were tried */
+		{
+			uncoverColumn(dlx, node);
+			descend = 0;
+			continue;
+		}
+		for (j=dlx->right[node]; j!=node; j=dlx->right[j])
+			coverColumn(dlx, dlx->column[j]);
+		level++;
+		descend = 1;
+	}
+	return count;
+}
+
+/*
+ * writeSolution
+ *
+ *  This function writes the options chosen in the first levels to the board (value=1), or empties
+ *  their cells again (value=0)
+ */
+void writeSolution(Dlx *dlx, Board *board, int levels, int value)
+{
+	int i, option, N = board->boardsize;
+	for (i=0; i<levels; i++)
+	{
+		option = dlx->option[dlx->choice[i]];
+		setCellValue(board, (option/N)/N, (option/N)%N, value ? option%N+1 : 0);
+	}
+}
+
+/* End of private methods */
@@ -0,0 +1,55 @@
+/*
+ * DLX Module
+ *
+ *  This module solves a sudoku board as an exact cover problem, using Knuth's Algorithm X
+ *  with dancing links. Every (cell,value) option is a row of the cover matrix, and the columns are
+ *  the constraints: each cell has one value, and each row, column and box has each value once.
+ *  The module can find one solution, count the solutions or go over all of them.
+ */
+
+#ifndef DLX_H_
+#define DLX_H_
+
+#include "game.h"
+
+/*
+ * dlxSolve
+ *
+ *  This function finds a solution of the board and fills the board's empty cells with it.
+ *  the board is not changed if there is no solution.
+ *  @param board - the board to solve
+ *  @return - 1 if solved, 0 if the board is unsolvable
+ */
+int dlxSolve(Board *board);
+
+/*
+ * dlxCount
+ *
+ *  This function counts the solutions of the board. the board is not changed.
+ *  @param board - the board
+ *  @param limit - stop counting after that many solutions (0 = count them all)
+ *  @return - number of solutions (at most limit)
+ */
+unsigned long dlxCount(Board *board, unsigned long limit);
+
+/*
+ * dlxEnumerate
+ *
+ *  This function goes over all the solutions of the board. for each solution the board's empty cells
+ *  are filled with it and the callback is called. after the callback the cells are emptied again.
+ *  @param board - the board
+ *  @param onSolution - called for every solution, returns 0 in order to stop the enumeration
+ *  @param data - passed to the callback
+ *  @return - number of solutions visited
+ */
+unsigned long dlxEnumerate(Board *board, int (*onSolution)(Board *board, void *data), void *data);
+
+/*
+ * dlxNodesCount
+ *
+ *  This function returns the number of search nodes of the last dlx run
+ *  @return - number of nodes
+ */
+unsigned long dlxNodesCount();
+
+#endif /* DLX_H_ */
@@ -14,6 +14,7 @@
 #include "mainAux.h"
 #include "solver.h"
 #include "parser.h"
+#include "kernels.h"
 
 /* Public methods: */
 
@@ -25,64 +26,54 @@
  *  @return - Board* - the initiate Board
  */
 Board* init(int n, int m){
-	Cell **board;
-	int i;
-	int k,l;
-	int size;
+	int size, words;
+	size_t cellsNum, wordsSize, intsSize;
 	Board* newBoard; /*the new board*/
 	size=n*m;
+	cellsNum=(size_t)size*size;
+	words=(size+WORDBITS-1)/WORDBITS;
 
-	/*first of all, we will create the actual cells of the board*/
-	board = malloc(size*sizeof(Cell *));
-	if(!board)
+	newBoard = malloc(sizeof(Board));
+	if(!newBoard)
 	{
 		printf("Error: malloc has failed\n");
 		exit(0);
 		return NULL;
 	}
-	for(i=0;i<size;i++)
-	{
-		board[i] = malloc(sizeof(Cell) *size);
-		if(!board[i])
-		{
-			printf("Error: malloc has failed\n");
-			exit(0);
-			return NULL;
-		}
-	}
 
-	for(k=0;k<size;k++)
-	{
-		for(l=0;l<size;l++)
-		{  /*the initial values of the cell*/
-			board[k][l].value = 0;
-			board[k][l].fixed = 0;
-			board[k][l].error = 0;
-			board[k][l].options = calloc(size, sizeof(int));
-			if(!board[k][l].options)
-				{
-					printf("Error: calloc has failed\n");
-					exit(0);
-					return NULL;
-				}
-			board[k][l].numOfOptions = 0;
-		}
-	}
-
-	/*now, we are about to create the whole board*/
-	newBoard = malloc(sizeof(Board));
-	if(!newBoard)
+	/* one block for the digits bitsets of the rows, columns and boxes (words), the cells' values, options,
+	 * numOfOptions and the units' digit counters (ints) and then the cells' fixed, error (chars).
+	 * calloc gives every cell its initial values (empty, not fixed, no error and no options) */
+	wordsSize = 3*(size_t)size*words*sizeof(unsigned long);
+	intsSize = (cellsNum + cellsNum*size + cellsNum + 3*cellsNum)*sizeof(int);
+	newBoard->storageSize = wordsSize + intsSize + 2*cellsNum*sizeof(char);
+	newBoard->storage = calloc(newBoard->storageSize, 1);
+	if(!newBoard->storage)
 	{
-		printf("Error: malloc has failed\n");
+		printf("Error: calloc has failed\n");
 		exit(0);
 		return NULL;
 	}
+	newBoard->rowDigits = (unsigned long*)newBoard->storage;
+	newBoard->columnDigits = newBoard->rowDigits + size*words;
+	newBoard->boxDigits = newBoard->columnDigits + size*words;
+	newBoard->values = (int*)(newBoard->boxDigits + size*words);
+	newBoard->options = newBoard->values + cellsNum;
+	newBoard->numOfOptions = newBoard->options + cellsNum*size;
+	newBoard->unitCounts = newBoard->numOfOptions + cellsNum;
+	newBoard->fixed = (char*)newBoard->storage + wordsSize + intsSize;
+	newBoard->error = newBoard->fixed + cellsNum;
+
 	/*fill the new board*/
 	newBoard->markErrors = 1;
-	newBoard->cells = board;
+	newBoard->filledNum = 0;
+	newBoard->errorsNum = 0;
+	newBoard->wordsPerUnit = words;
 	newBoard->n = n;
 	newBoard->m = m;
 	newBoard->boardsize = size;
+	newBoard->geometry = acquireGeometry(n, m);
+	newBoard->kernels = findKernels(n, m);
 
 	return newBoard;
 }
@@ -119,18 +110,18 @@ void printBoard(Board *board)
 
 			printf(" ");
 
-			if (board->cells[i][j].fixed==1)
+			if (board->fixed[CELL(board,i,j)]==1)
 				specialSign = '.';
-			else if (board->cells[i][j].error == 1 && board->markErrors == 1)
+			else if (board->error[CELL(board,i,j)] == 1 && board->markErrors == 1)
 				specialSign = '*';
 				else
 				    specialSign = ' ';
 
 			/*prints special sign if needed - error or fixed*/
-			if (board->cells[i][j].value==0)
+			if (board->values[CELL(board,i,j)]==0)
 				printf("  %c",specialSign);
 			else
-				printf("%2d%c",board->cells[i][j].value, specialSign);
+				printf("%2d%c",board->values[CELL(board,i,j)], specialSign);
 
 		}
 		printf("|\n");
@@ -147,7 +138,7 @@ void printBoard(Board *board)
  *
  *  This function gets partially solved board, and sets a value in the desired location, if possible
  *  @param board - the user's board
- *  @param list - the doubly linked list which stores the moves
+ *  @param list - the undo log which stores the moves
  *  @param x - column number
  *  @param y - row number
  *  @param z - value
@@ -157,30 +148,19 @@ void printBoard(Board *board)
 int set(Board *board, List *undoList, int x, int y, int z, int gameMode)
 {
 	int prevValue;
-	int** moves;
-	Node* newNode = NULL;
 	/* cannot set if fixed */
-	if(board->cells[x][y].fixed == 1)
+	if(board->fixed[CELL(board,x,y)] == 1)
 	{
 		printf("Error: cell is fixed\n");
 		return 0;
 	}
 
-	prevValue = board->cells[x][y].value;
-	board->cells[x][y].value = z;
+	prevValue = board->values[CELL(board,x,y)];
+	setCellValue(board,x,y,z);
 
-	/*node preparation*/
-	moves = malloc(sizeof(int*));
-	if(!moves)
-	{
-		printf("Error: malloc has failed\n");
-		exit(0);
-		return 0;
-	}
-	insertSingleMove(moves, 0, x, y, prevValue, z);
-	updateMovesInNode(&newNode,moves, 1);
-	addMove(undoList,newNode);
-	/* end of node preparation */
+	/* a turn of a single move */
+	recordMove(undoList, CELL(board,x,y), prevValue, z);
+	endTurn(undoList);
 
 	markErrors(board,x,y);
 	printBoard(board);
@@ -211,7 +191,7 @@ int set(Board *board, List *undoList, int x, int y, int z, int gameMode)
  */
 void hint(Board *solvedBoard, int x, int y)
 {
-	printf("Hint: set cell to %d\n", solvedBoard->cells[x][y].value);
+	printf("Hint: set cell to %d\n", solvedBoard->values[CELL(solvedBoard,x,y)]);
 }
 
 /*
@@ -220,7 +200,7 @@ void hint(Board *solvedBoard, int x, int y)
  *  This function redoes the last undone operation of user that affected the board.
  *
  *  @param board - pointer to the game board
- *  @param undoList - the doubly linked list which stores the moves
+ *  @param undoList - the undo log which stores the moves
  *  @param printVal - whether of not the function print its actions
  *  @param mode - a pointer to the current game mode
  *  @return -
@@ -228,26 +208,25 @@ void hint(Board *solvedBoard, int x, int y)
 void redo(Board* board, List* undoList, int printVal, int* mode)
 {
 	int x,y,z,prevValue,movesNum,i;
+	Move* moves;
 	/* if we are pointing on the last move done by the user, then no moves to undo */
-	if(undoList->current->next == NULL){
+	if(undoList->current == undoList->turnsNum){
 		if(printVal)
 			printf("Error: no moves to redo\n");
 	}
 	else{
-		/* go to the next node in the list */
-		undoList->current = undoList->current->next;
-		/* check how many moves were in the last user's turn */
-		movesNum = undoList->current->movesNum;
+		/* go to the next turn in the log */
+		undoList->current++;
+		/* the moves of the user's turn */
+		moves = turnMoves(undoList, undoList->current, &movesNum);
 		for(i=0;i<movesNum;i++){
-			/* for each move in the 2d moves array, store move data temporarely */
-			x=undoList->current->moves[i][0];
-			y=undoList->current->moves[i][1];
-			prevValue = undoList->current->moves[i][2];
-			z=undoList->current->moves[i][3];
+			/* for each move in the turn, store move data temporarely */
+			x=moves[i].cell/board->boardsize;
+			y=moves[i].cell%board->boardsize;
+			prevValue = moves[i].prevValue;
+			z=moves[i].value;
 			/* update the game board accordingly (for each single move in user's turn)*/
-			board->cells[x][y].value = z;
-			/* check for errors */
-			markErrors(board, x, y);
+			setCellValue(board,x,y,z);
 			if(printVal) /* print only if we need */
 			{
 				if(prevValue==0 && z==0)
@@ -259,19 +238,20 @@ void redo(Board* board, List* undoList, int printVal, int* mode)
 				else
 					printf("Redo %d,%d: from %d to %d\n",y+1,x+1, prevValue, z);
 			}
+		}
+		/* check for errors - once for the whole turn */
+		markMovesErrors(board, moves, movesNum);
 
-
-			if (*mode==1)  /*relevant only to solve mode */
+		if (*mode==1)  /*relevant only to solve mode */
+		{
+			if(isBoardFull(board))
 			{
-				if(isBoardFull(board))
+				if (isThereAnError(board))
+					printf("Puzzle solution erroneous\n");
+				else
 				{
-					if (isThereAnError(board))
-						printf("Puzzle solution erroneous\n");
-					else
-					{
-						printf("Puzzle solved successfully\n");
-						(*mode) = 0;
-					}
+					printf("Puzzle solved successfully\n");
+					(*mode) = 0;
 				}
 			}
 		}
@@ -284,31 +264,30 @@ void redo(Board* board, List* undoList, int printVal, int* mode)
  *  This function undoes the last operation of user that affected the board.
  *
  *  @param board - pointer to the game board
- *  @param undoList - the doubly linked list which stores the moves
+ *  @param undoList - the undo log which stores the moves
  *  @param printVal - whether of not the function print its actions
  *  @return -
  */
 void undo(Board* board, List* undoList, int printVal)
 {
 	int x,y,z,prevValue,movesNum,i;
+	Move* moves;
 	/* if we are pointing on the first move done by the user, then no moves to undo */
-	if(undoList->current->prev == NULL){
+	if(undoList->current == 0){
 		if(printVal)
 			printf("Error: no moves to undo\n");
 	}
 	else{
-		/* check how many moves were in the last user's turn */
-		movesNum = undoList->current->movesNum;
+		/* the moves of the last user's turn */
+		moves = turnMoves(undoList, undoList->current, &movesNum);
 		for(i=0;i<movesNum;i++){
-			/* for each move in the 2d moves array, store move data temporarely */
-			x=undoList->current->moves[i][0];
-			y=undoList->current->moves[i][1];
-			z=undoList->current->moves[i][2];
-			prevValue = undoList->current->moves[i][3];
+			/* for each move in the turn, store move data temporarely */
+			x=moves[i].cell/board->boardsize;
+			y=moves[i].cell%board->boardsize;
+			z=moves[i].prevValue;
+			prevValue = moves[i].value;
 			/* update the game board accordingly (for each single move in user's turn)*/
-			board->cells[x][y].value = z;
-			/* check for errors */
-			markErrors(board, x, y);
+			setCellValue(board,x,y,z);
 			if(printVal) /* print only if we need */
 			{
 				if(prevValue==0 && z==0)
@@ -321,24 +300,24 @@ void undo(Board* board, List* undoList, int printVal)
 					printf("Undo %d,%d: from %d to %d\n",y+1,x+1, prevValue, z);
 			}
 		}
-		undoList->current = undoList->current->prev; /* go to the previous node */
+		/* check for errors - once for the whole turn */
+		markMovesErrors(board, moves, movesNum);
+		undoList->current--; /* go to the previous turn */
 	}
 }
 
 /*
  * reset
  *
- *  This function reset the game board to his first stage, meaning undo all the moves that were done by the user
+ *  This function reset the game board to his first stage, meaning undo all the moves that were done by the user.
+ *  the first stage is the log's checkpoint, so it is restored by one copy instead of undoing every move
  *  @param userBoard - the user's board
- *  @param undoList - a pointer to the doubly linked list which stores the moves
+ *  @param undoList - a pointer to the undo log which stores the moves
  *  @return -
  */
 void reset(Board* board, List** undoList){
-	while((*undoList)->current->prev != NULL){
-		undo(board,*undoList,0);
-	}
-	destroyList(*undoList);
-	*undoList = initList();
+	setBoardStorage(board, (*undoList)->checkpoint);
+	clearList(*undoList);
 	printf("Board reset\n");
 }
 
@@ -348,7 +327,7 @@ void reset(Board* board, List** undoList){
  *
  *  This function free all memory block and quits.
  *  @param userBoard - the user's board
- *  @param undoList - the doubly linked list which stores the moves
+ *  @param undoList - the undo log which stores the moves
  *  @return -
  */
 void exitGame(Board *userBoard, List *undoList)
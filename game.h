@@ -8,41 +8,75 @@
  *  a specific operation/stage in the game is here. (such as initialize board, set,hint,validate etc)
  */
 
+#include <stddef.h>
 #include "undoList.h"
-
-/* ---The cell struct--
- * this struct is used for describing a specific sudoku cell
- * contains the following:
- * -value field
- * -fixed field
- * -error value
- * -optional values array
- * -number of optional values in array field
- */
-typedef struct cell{
-	int value;
-	int fixed;
-	int error;
-	int *options;
-	int numOfOptions;
-} Cell;
+#include "geometry.h"
 
 /* ---The board struct--
  * this struct is used for describing a sudoku board
- * contains the follwing:
- * -game cells
+ * all the cells data is kept in a single memory block (storage) which is split into
+ * packed arrays. each array is indexed by the cell index (see the CELL macro):
+ * -values array
+ * -fixed flags array
+ * -error flags array
+ * -optional values array (boardsize entries for every cell)
+ * -number of optional values array
+ * the block also keeps, for every row, column and box, a bitset of the digits which are used in it
+ * (bit value-1 of the unit's words, wordsPerUnit words per unit) so checking a value is a few AND operations,
+ * and the number of cells which hold every digit in it (an erroneous unit holds a digit more than once).
+ * contains also the follwing:
  * -n,m parameters
  * -the boardsize parameter (n*m)
+ * -the tables of the board's geometry, shared by all the boards of the same n,m (see geometry.h)
+ * -the kernels of the board's geometry (see kernels.h)
  * markErrors field (1=mark, 0=do not mark)
+ * the number of filled cells and the number of erroneous cells, kept by every change of a value or of an
+ * error flag, so the board's status is known without scanning it
  */
 typedef struct board{
-	Cell **cells;
+	int *values;
+	int *options;
+	int *numOfOptions;
+	char *fixed;
+	char *error;
+	unsigned long *rowDigits;
+	unsigned long *columnDigits;
+	unsigned long *boxDigits;
+	int *unitCounts; /* for every unit (the rows, then the columns, then the boxes): boardsize counters */
+	int wordsPerUnit;
+	void *storage; /* the memory block all the arrays above point into */
+	size_t storageSize;
 	int n;
 	int m;
 	int boardsize;
+	Geometry *geometry;
+	const struct kernels *kernels;
 	int markErrors;
+	int filledNum;
+	int errorsNum;
 } Board;
 
+/* A snapshot of a board's values, which lets a solver work on the board itself instead of on a copy of it.
+ * a solver only fills empty cells (and gives the board back unchanged when it fails), so the snapshot keeps
+ * only the cells which were empty when it was taken, and the board goes back to it by emptying them again */
+typedef struct snapshot {
+	Board *board;
+	int *emptyCells;
+	int emptyNum;
+	size_t mark; /* the arena's top before the snapshot was taken */
+} Snapshot;
+
+/* the index of the cell in row "row" and column "column" inside the board's arrays */
+#define CELL(board,row,column) ((row)*(board)->boardsize+(column))
+
+/* the index of the box which contains the cell in row "row" and column "column" */
+#define BOX(board,row,column) ((board)->geometry->cellUnits[3*CELL(board,row,column)+2])
+
+/* digits bitsets: the number of bits in a word, the word and the bit of a value (1..boardsize) */
+#define WORDBITS (8*sizeof(unsigned long))
+#define DIGITWORD(value) (((value)-1)/WORDBITS)
+#define DIGITBIT(value) (1UL<<(((value)-1)%WORDBITS))
+
 /*
  * init
  *
@@ -67,7 +101,7 @@ void printBoard(Board *board);
  *
  *  This function gets partially solved board, and sets a value in the desired location, if possible
  *  @param board - the user's board
- *  @param list - the doubly linked list which stores the moves
+ *  @param list - the undo log which stores the moves
  *  @param x - column number
  *  @param y - row number
  *  @param z - value
@@ -93,7 +127,7 @@ void hint(Board *solvedBoard, int x, int y);
  *  This function redoes the last undone operation of user that affected the board.
  *
  *  @param board - pointer to the game board
- *  @param undoList - the doubly linked list which stores the moves
+ *  @param undoList - the undo log which stores the moves
  *  @param printVal - whether of not the function print its actions
  *  @param mode - a pointer to the current game mode
  *  @return -
@@ -106,7 +140,7 @@ void redo(Board* board, List* undoList, int printVal, int* mode);
  *  This function undoes the last operation of user that affected the board.
  *
  *  @param board - pointer to the game board
- *  @param undoList - the doubly linked list which stores the moves
+ *  @param undoList - the undo log which stores the moves
  *  @param printVal - whether of not the function print its actions
  *  @return -
  */
@@ -115,9 +149,10 @@ void undo(Board* board, List* undoList, int printVal);
 /*
  * reset
  *
- *  This function reset the game board to his first stage, meaning undo all the moves that were done by the user
+ *  This function reset the game board to his first stage, meaning undo all the moves that were done by the user.
+ *  the first stage is the log's checkpoint, so it is restored by one copy instead of undoing every move
  *  @param userBoard - the user's board
- *  @param undoList - a pointer to the doubly linked list which stores the moves
+ *  @param undoList - a pointer to the undo log which stores the moves
  *  @return -
  */
 void reset(Board* board, List** undoList);
@@ -127,7 +162,7 @@ void reset(Board* board, List** undoList);
  *
  *  This function free all memory block and quits.
  *  @param userBoard - the user's board
- *  @param undoList - the doubly linked list which stores the moves
+ *  @param undoList - the undo log which stores the moves
  *  @return -
  */
 void exitGame(Board *userBoard, List* undoList);
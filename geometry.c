@@ -0,0 +1,151 @@
+/*
+ * Geometry Module
+ *
+ *  This module keeps the tables of a board's geometry (n,m), which are computed once instead of on
+ *  every access: the row, column and box of every cell, the cells of every unit, and the peers of
+ *  every cell - the cells which share a row, column or box with it, each one listed once.
+ *  All the boards of the same geometry share one copy of the tables, which is freed when the last of
+ *  them is destroyed. The boards are created and destroyed by the main thread only (the counting
+ *  threads only read the tables).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "geometry.h"
+
+static Geometry *geometries = NULL; /* the geometries in use */
+
+/* private methods declaration: */
+Geometry* buildGeometry(int n, int m);
+void destroyGeometry(Geometry *geometry);
+
+/* Public methods: */
+
+/*
+ * acquireGeometry
+ *
+ *  This function returns the tables of a geometry: the shared ones if some board already uses them,
+ *  otherwise new ones. every call has to be matched by a call to releaseGeometry.
+ *  @param n - the number of columns in a box
+ *  @param m - the number of rows in a box
+ *  @return - the geometry's tables
+ */
+Geometry* acquireGeometry(int n, int m)
+{
+	Geometry *geometry;
+	for (geometry=geometries; geometry!=NULL; geometry=geometry->next)
+		if (geometry->n==n && geometry->m==m)
+			break;
+	if (geometry==NULL)
+	{
+		geometry = buildGeometry(n, m);
+		geometry->next = geometries;
+		geometries = geometry;
+	}
+	geometry->references++;
+	return geometry;
+}
+
+/*
+ * releaseGeometry
+ *
+ *  This function releases the tables of a geometry which a board does not use anymore. the tables are
+ *  freed when no board uses them.
+ *  @param geometry - the tables (NULL is ignored)
+ *  @return -
+ */
+void releaseGeometry(Geometry *geometry)
+{
+	Geometry **entry;
+	if (geometry==NULL || --geometry->references>0)
+		return;
+	for (entry=&geometries; *entry!=geometry; entry=&(*entry)->next);
+	*entry = geometry->next;
+	destroyGeometry(geometry);
+}
+
+/* End of public methods */
+
+/* Private methods: */
+
+/*
+ * buildGeometry
+ *
+ *  This function computes the tables of a geometry. the peers of a cell are its row, then the rest of
+ *  its column, then the rest of its box.
+ */
+Geometry* buildGeometry(int n, int m)
+{
+	int cell, kind, unit, i, other, count, N=n*m;
+	int *seen, *cellUnits;
+	Geometry *geometry = malloc(sizeof(Geometry));
+	if (!geometry)
+	{
+		printf("Error: malloc has failed\n");
+		exit(0);
+	}
+	geometry->n = n;
+	geometry->m = m;
+	geometry->boardsize = N;
+	geometry->peersNum = 2*(N-1) + (n-1)*(m-1);
+	geometry->references = 0;
+	geometry->next = NULL;
+	geometry->cellUnits = malloc(3*N*N*sizeof(int));
+	geometry->unitCells = malloc(3*N*N*sizeof(int));
+	geometry->peers = malloc(N*N*geometry->peersNum*sizeof(int) + 1); /* a 1x1 board has no peers */
+	seen = malloc(N*N*sizeof(int));
+	if (!geometry->cellUnits || !geometry->unitCells || !geometry->peers || !seen)
+	{
+		printf("Error: malloc has failed\n");
+		exit(0);
+	}
+
+	for (cell=0; cell<N*N; cell++)
+	{
+		geometry->cellUnits[3*cell] = cell/N;
+		geometry->cellUnits[3*cell+1] = cell%N;
+		geometry->cellUnits[3*cell+2] = ((cell/N)/m)*m + (cell%N)/n;
+		seen[cell] = -1;
+	}
+	/* box "unit" starts at row (unit/m)*m and column (unit%m)*n, and has m rows of n cells */
+	for (unit=0; unit<N; unit++)
+		for (i=0; i<N; i++)
+		{
+			geometry->unitCells[unit*N+i] = unit*N+i;
+			geometry->unitCells[(N+unit)*N+i] = i*N+unit;
+			geometry->unitCells[(2*N+unit)*N+i] = ((unit/m)*m + i/n)*N + (unit%m)*n + i%n;
+		}
+
+	for (cell=0; cell<N*N; cell++)
+	{
+		cellUnits = geometry->cellUnits + 3*cell;
+		count = 0;
+		seen[cell] = cell;
+		for (kind=0; kind<3; kind++)
+			for (i=0; i<N; i++)
+			{
+				other = geometry->unitCells[(kind*N+cellUnits[kind])*N+i];
+				if (seen[other]==cell)
+					continue;
+				seen[other] = cell;
+				geometry->peers[cell*geometry->peersNum+count++] = other;
+			}
+	}
+	free(seen);
+	return geometry;
+}
+
+/*
+ * destroyGeometry
+ *
+ *  This function frees the tables of a geometry
+ */
+void destroyGeometry(Geometry *geometry)
+{
+	free(geometry->cellUnits);
+	free(geometry->unitCells);
+	free(geometry->peers);
+	free(geometry);
+}
+
+/* End of private methods */
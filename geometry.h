@@ -0,0 +1,49 @@
+/*
+ * Geometry Module
+ *
+ *  This module keeps the tables of a board's geometry (n,m), which are computed once instead of on
+ *  every access: the row, column and box of every cell, the cells of every unit, and the peers of
+ *  every cell - the cells which share a row, column or box with it, each one listed once.
+ *  All the boards of the same geometry share one copy of the tables, which is freed when the last of
+ *  them is destroyed. The boards are created and destroyed by the main thread only (the counting
+ *  threads only read the tables).
+ */
+
+#ifndef GEOMETRY_H_
+#define GEOMETRY_H_
+
+/* The tables of a geometry. a unit is a row (kind 0), a column (kind 1) or a box (kind 2) */
+typedef struct geometry {
+	int n;
+	int m;
+	int boardsize;
+	int *cellUnits; /* for every cell: its row, column and box */
+	int *unitCells; /* for every unit (the rows, then the columns, then the boxes): its cells */
+	int *peers; /* for every cell: its peersNum peers */
+	int peersNum;
+	int references; /* the number of boards which use the tables */
+	struct geometry *next; /* the list of the geometries in use */
+} Geometry;
+
+/*
+ * acquireGeometry
+ *
+ *  This function returns the tables of a geometry: the shared ones if some board already uses them,
+ *  otherwise new ones. every call has to be matched by a call to releaseGeometry.
+ *  @param n - the number of columns in a box
+ *  @param m - the number of rows in a box
+ *  @return - the geometry's tables
+ */
+Geometry* acquireGeometry(int n, int m);
+
+/*
+ * releaseGeometry
+ *
+ *  This function releases the tables of a geometry which a board does not use anymore. the tables are
+ *  freed when no board uses them.
+ *  @param geometry - the tables (NULL is ignored)
+ *  @return -
+ */
+void releaseGeometry(Geometry *geometry);
+
+#endif /* GEOMETRY_H_ */
@@ -0,0 +1,179 @@
+/*
+ * Kernels Module
+ *
+ *  This module holds the hot board kernels - checking whether a value is valid for a cell, and marking
+ *  the errors around a cell - instantiated at compile time for the common box geometries (2x2, 2x3, 3x3,
+ *  3x4, 4x4 and 5x5, and the transposed rectangles). All the instances come from one macro, so in every
+ *  instance the box sizes and the loops bounds are constants: the compiler can unroll the unit scans and
+ *  replace the divisions, and no table is read. Every board gets the kernels of its geometry when it is
+ *  created (the generic ones, which read the geometry tables, for any other geometry).
+ */
+
+#include "game.h"
+#include "kernels.h"
+
+/*
+ * DECLARE_KERNELS / DEFINE_KERNELS
+ *
+ *  The kernels of a geometry, named by "name" (isValid_3x3 and so on). N and M are the number of columns
+ *  and rows of a box. The instances work with constant arithmetic only: the cell's box is computed from
+ *  its row and column (the divisions are by constants) and the units are scanned by constant bounds loops,
+ *  so no table is read. The generic kernels, for any other geometry, read the board's geometry tables.
+ *
+ *  isValid - 1 if the value is not used in the cell's row, column and box (by the digits bitsets)
+ *  isErroneous - 1 if the cell's value appears in one of its peers: one of the cell's units holds the value
+ *                more than once (by the units counters)
+ *  markErrors - updates the error flags of the cell and its peers (its row, the rest of its column and the
+ *               rest of its box), and the board's errors count
+ */
+/* sets the error flag of a cell (through the variable "error") and keeps the board's errors count */
+#define UPDATE_ERROR(board, cell, isErroneous, error) \
+	((error) = (isErroneous), (board)->errorsNum += (error) - (board)->error[cell], (board)->error[cell] = (char)(error))
+
+#define DECLARE_KERNELS(name) \
+int isValid_##name(Board *board, int row, int column, int value); \
+int isErroneous_##name(Board *board, int row, int column); \
+void markErrors_##name(Board *board, int row, int column);
+
+#define DEFINE_KERNELS(name, N, M) \
+int isValid_##name(Board *board, int row, int column, int value) \
+{ \
+	const int words=((N)*(M)+(int)WORDBITS-1)/(int)WORDBITS; \
+	int word=DIGITWORD(value), box=(row/(M))*(M) + column/(N); \
+	unsigned long bit=DIGITBIT(value); \
+	return !((board->rowDigits[row*words+word] | board->columnDigits[column*words+word] \
+			| board->boxDigits[box*words+word]) & bit); \
+} \
+\
+int isErroneous_##name(Board *board, int row, int column) \
+{ \
+	const int size=(N)*(M); \
+	int value=board->values[row*size+column], box=(row/(M))*(M) + column/(N); \
+	if (value==0) \
+		return 0; \
+	return board->unitCounts[row*size+value-1]>1 \
+			|| board->unitCounts[(size+column)*size+value-1]>1 \
+			|| board->unitCounts[(2*size+box)*size+value-1]>1; \
+} \
+\
+void markErrors_##name(Board *board, int row, int column) \
+{ \
+	const int size=(N)*(M); \
+	int i, j, error, top=(row/(M))*(M), left=(column/(N))*(N); \
+	for (j=0; j<size; j++) \
+		UPDATE_ERROR(board, row*size+j, isErroneous_##name(board, row, j), error); \
+	for (i=0; i<size; i++) \
+		if (i!=row) \
+			UPDATE_ERROR(board, i*size+column, isErroneous_##name(board, i, column), error); \
+	for (i=top; i<top+(M); i++) \
+		for (j=left; j<left+(N); j++) \
+			if (i!=row && j!=column) \
+				UPDATE_ERROR(board, i*size+j, isErroneous_##name(board, i, j), error); \
+}
+
+/* an entry of the dispatch table */
+#define KERNELS(name, N, M) {N, M, isValid_##name, isErroneous_##name, markErrors_##name}
+
+/* private methods declaration: */
+DECLARE_KERNELS(generic)
+DECLARE_KERNELS(2x2)
+DECLARE_KERNELS(2x3)
+DECLARE_KERNELS(3x2)
+DECLARE_KERNELS(3x3)
+DECLARE_KERNELS(3x4)
+DECLARE_KERNELS(4x3)
+DECLARE_KERNELS(4x4)
+DECLARE_KERNELS(5x5)
+
+/* the dispatch table, by (n,m) */
+static const Kernels kernelsTable[] = {
+	KERNELS(2x2, 2, 2),
+	KERNELS(2x3, 2, 3),
+	KERNELS(3x2, 3, 2),
+	KERNELS(3x3, 3, 3),
+	KERNELS(3x4, 3, 4),
+	KERNELS(4x3, 4, 3),
+	KERNELS(4x4, 4, 4),
+	KERNELS(5x5, 5, 5)
+};
+
+static const Kernels genericKernels = KERNELS(generic, 0, 0);
+
+/* Public methods: */
+
+/*
+ * findKernels
+ *
+ *  This function looks up the kernels of a geometry in the dispatch table
+ *  @param n - the number of columns in a box
+ *  @param m - the number of rows in a box
+ *  @return - the geometry's kernels, or the generic kernels if the geometry has no instance
+ */
+const Kernels* findKernels(int n, int m)
+{
+	int i;
+	for (i=0; i<(int)(sizeof(kernelsTable)/sizeof(kernelsTable[0])); i++)
+		if (kernelsTable[i].n==n && kernelsTable[i].m==m)
+			return &kernelsTable[i];
+	return &genericKernels;
+}
+
+/* End of public methods */
+
+/* Private methods: */
+
+/*
+ * isValid_generic
+ *
+ *  This function is the isValid kernel of any geometry: the cell's box comes from the geometry tables
+ */
+int isValid_generic(Board *board, int row, int column, int value)
+{
+	int words=board->wordsPerUnit, word=DIGITWORD(value);
+	int box=board->geometry->cellUnits[3*CELL(board,row,column)+2];
+	unsigned long bit=DIGITBIT(value);
+	return !((board->rowDigits[row*words+word] | board->columnDigits[column*words+word]
+			| board->boxDigits[box*words+word]) & bit);
+}
+
+/*
+ * isErroneous_generic
+ *
+ *  This function is the isErroneous kernel of any geometry: the cell's units come from the geometry tables
+ */
+int isErroneous_generic(Board *board, int row, int column)
+{
+	int size=board->boardsize, value=board->values[CELL(board,row,column)];
+	int *cellUnits=board->geometry->cellUnits + 3*CELL(board,row,column);
+	if (value==0)
+		return 0;
+	return board->unitCounts[cellUnits[0]*size+value-1]>1
+			|| board->unitCounts[(size+cellUnits[1])*size+value-1]>1
+			|| board->unitCounts[(2*size+cellUnits[2])*size+value-1]>1;
+}
+
+/*
+ * markErrors_generic
+ *
+ *  This function is the markErrors kernel of any geometry: it walks the cell's peers list of the geometry
+ *  tables
+ */
+void markErrors_generic(Board *board, int row, int column)
+{
+	int i, error, size=board->boardsize, peersNum=board->geometry->peersNum;
+	int *peers=board->geometry->peers + CELL(board,row,column)*peersNum;
+	UPDATE_ERROR(board, CELL(board,row,column), isErroneous_generic(board, row, column), error);
+	for (i=0; i<peersNum; i++)
+		UPDATE_ERROR(board, peers[i], isErroneous_generic(board, peers[i]/size, peers[i]%size), error);
+}
+
+DEFINE_KERNELS(2x2, 2, 2)
+DEFINE_KERNELS(2x3, 2, 3)
+DEFINE_KERNELS(3x2, 3, 2)
+DEFINE_KERNELS(3x3, 3, 3)
+DEFINE_KERNELS(3x4, 3, 4)
+DEFINE_KERNELS(4x3, 4, 3)
+DEFINE_KERNELS(4x4, 4, 4)
+DEFINE_KERNELS(5x5, 5, 5)
+
+/* End of private methods */
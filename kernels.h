@@ -0,0 +1,36 @@
+/*
+ * Kernels Module
+ *
+ *  This module holds the hot board kernels - checking whether a value is valid for a cell, and marking
+ *  the errors around a cell - instantiated at compile time for the common box geometries (2x2, 2x3, 3x3,
+ *  3x4, 4x4 and 5x5, and the transposed rectangles). All the instances come from one macro, so in every
+ *  instance the box sizes and the loops bounds are constants: the compiler can unroll the unit scans and
+ *  replace the divisions, and no table is read. Every board gets the kernels of its geometry when it is
+ *  created (the generic ones, which read the geometry tables, for any other geometry).
+ */
+
+#ifndef KERNELS_H_
+#define KERNELS_H_
+
+#include "game.h"
+
+/* The kernels of one geometry (n,m) */
+typedef struct kernels {
+	int n;
+	int m;
+	int (*isValid)(Board *board, int row, int column, int value);
+	int (*isErroneous)(Board *board, int row, int column);
+	void (*markErrors)(Board *board, int row, int column);
+} Kernels;
+
+/*
+ * findKernels
+ *
+ *  This function looks up the kernels of a geometry in the dispatch table
+ *  @param n - the number of columns in a box
+ *  @param m - the number of rows in a box
+ *  @return - the geometry's kernels, or the generic kernels if the geometry has no instance
+ */
+const Kernels* findKernels(int n, int m);
+
+#endif /* KERNELS_H_ */
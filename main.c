@@ -7,20 +7,44 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 #include "game.h"
+#include "solver.h"
+#include "parallel.h"
 #include "SPBufferset.h"
 
 /*
  * main
  *
- *  This function is executed first, sets a default random seed
+ *  This function is executed first, sets a default random seed, reads the command line options
  *  and calls the startGame function in order to start the game
+ *  the options are:
+ *  --threads <k> - number of threads which count solutions in num_solutions (default 1)
+ *  --solver <name> - the engine which solves and counts boards (default dlx, and the classic
+ *                   engine for 9x9 boards)
+ *  --history <moves> - number of undo moves kept in memory, the older ones are kept in a temporary file
+ *                      (default 1048576)
+ *  @param argc - number of command line arguments
+ *  @param argv - the command line arguments
  *  @return 0 (always)
  */
-int main(){
+int main(int argc, char *argv[]){
+	int i;
 	SP_BUFF_SET();
 	srand(time(NULL)); /* default seed for randomization */
+	for(i=1;i<argc;i++)
+	{
+		if(strcmp(argv[i],"--threads")==0 && i+1<argc)
+			setCountingThreads(atoi(argv[++i]));
+		else if(strcmp(argv[i],"--history")==0 && i+1<argc)
+			setHistoryBudget(atoi(argv[++i]));
+		else if(strcmp(argv[i],"--solver")==0 && i+1<argc)
+		{
+			if(!selectSolver(argv[++i]))
+				printf("Error: unknown solver %s\n", argv[i]);
+		}
+	}
 	startGame();
 	return 0;
 }
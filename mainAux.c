@@ -16,16 +16,18 @@
 #include "solver.h"
 #include "tools.h"
 #include "ILPSolver.h"
+#include "sat.h"
+#include "arena.h"
 
 #define INITBOXSIZE 3 /* A constant for initial block size */
 
 /* private methods declaration: */
 void addOption(int *options, int value, int boardsize);
 void removeOption(int *options, int index, int boardsize);
-int* copyOption(int *options, int size);
-void resetOption(int *options, int size);
 void printArray(int *arr, int size);
+int bitCount(unsigned long word);
 int isInt(char* string);
+int printSolution(Board* board, void* data);
 
 /* Public methods: */
 
@@ -62,7 +64,7 @@ void doSave(Board* userBoard, char *path, int mode)
  *  This function validate the path it gets, and init the board from the file respectively
  *  @param path - a pointer to the desired path
  *  @param userBoard - the user's board
- *  @param list - the doubly linked list which stores the moves
+ *  @param list - the undo log which stores the moves
  *  @param mode - the current game mode
  *  @param currentMarkErrors - the current mark errors field
  *  @return -
@@ -82,6 +84,7 @@ void doSolve(char *path, Board** userBoard, List** undoList,int* mode, int curre
 		load(path,userBoard,*mode);
 		destroyList(*undoList);
 		(*undoList) = initList();
+		setCheckpoint(*undoList, (*userBoard)->storage, (*userBoard)->storageSize);
 		(*userBoard)->markErrors = currentMarkErrors;
 		printBoard(*userBoard);
 		fclose(fp);
@@ -94,7 +97,7 @@ void doSolve(char *path, Board** userBoard, List** undoList,int* mode, int curre
  *  This function validate the path it gets, and init the board from the file respectively
  *  @param path - a pointer to the desired path
  *  @param userBoard - the user's board
- *  @param list - the doubly linked list which stores the moves
+ *  @param list - the undo log which stores the moves
  *  @param mode - the current game mode
  *  @return -
  */
@@ -116,6 +119,7 @@ void doEdit(char *path,Board** userBoard, List** undoList, int* mode)
 			(*userBoard)->markErrors = 1;/* mark errors parameter is 1 */
 			destroyList(*undoList);
 			*undoList = initList();
+			setCheckpoint(*undoList, (*userBoard)->storage, (*userBoard)->storageSize);
 			printBoard(*userBoard);
 			fclose(fp);
 		}
@@ -129,6 +133,7 @@ void doEdit(char *path,Board** userBoard, List** undoList, int* mode)
 		(*userBoard)->markErrors = 1;/* mark errors parameter is 1 */
 		destroyList(*undoList);
 		*undoList = initList();
+		setCheckpoint(*undoList, (*userBoard)->storage, (*userBoard)->storageSize);
 		printBoard(*userBoard);
 	}
 }
@@ -157,31 +162,74 @@ void doValidate(Board* userBoard)
  *
  *  This function validates whether the board is erroneous or not, if not - gets the number of solutions and prints it
  *  @param userBoard - the user's board
+ *  @param limit - the field the user sent to the command: the number of solutions to stop at (NULL for none)
  *  @return -
  */
-void doNumSolutions(Board* userBoard){
+void doNumSolutions(Board* userBoard, char* limit){
 
-	int numSolutions;
+	unsigned long numSolutions, maxSolutions=0;
+	int overflow;
+	if(limit!=NULL)
+	{
+		if(!isInt(limit) || strlen(limit)==0 || strtoul(limit,NULL,10)==0)
+		{
+			printf("Error: the limit should be a positive integer\n");
+			return;
+		}
+		maxSolutions = strtoul(limit,NULL,10);
+	}
 	if(isThereAnError(userBoard))
 		printf("Error: board contains erroneous values\n");
 	else
 	{
-		numSolutions=getNumSolutions(userBoard);
-		printf("Number of solutions: %d\n", numSolutions);
+		numSolutions=getNumSolutions(userBoard, maxSolutions, &overflow);
+		if(overflow)
+			printf("Number of solutions: at least %lu\n", numSolutions);
+		else
+			printf("Number of solutions: %lu\n", numSolutions);
 
-		if(numSolutions==1)
+		if(numSolutions==1 && !overflow)
 			printf("This is a good board!\n");
-		else if(numSolutions>1)
+		else if(numSolutions>1 || overflow)
 			printf("The puzzle has more than 1 solution, try to edit it further\n");
 	}
 }
 
+/*
+ * doPrintSolutions
+ *
+ *  This function validates whether the board is erroneous or not, if not - prints its solutions, one board after the other
+ *  @param userBoard - the user's board
+ *  @param limit - the field the user sent to the command: the number of solutions to stop at (NULL for none)
+ *  @return -
+ */
+void doPrintSolutions(Board* userBoard, char* limit){
+
+	unsigned long numSolutions, maxSolutions=0;
+	if(limit!=NULL)
+	{
+		if(!isInt(limit) || strlen(limit)==0 || strtoul(limit,NULL,10)==0)
+		{
+			printf("Error: the limit should be a positive integer\n");
+			return;
+		}
+		maxSolutions = strtoul(limit,NULL,10);
+	}
+	if(isThereAnError(userBoard))
+		printf("Error: board contains erroneous values\n");
+	else
+	{
+		numSolutions=enumerateSolutions(userBoard, printSolution, &maxSolutions);
+		printf("Number of printed solutions: %lu\n", numSolutions);
+	}
+}
+
 /*
  * doAutoFill
  *
  *  This function validates whether the board is erroneous or not, if not - autofill it and check if the board is solved
  *  @param userBoard - the user's board
- *  @param list - the doubly linked list which stores the moves
+ *  @param list - the undo log which stores the moves
  *  @param mode - the current game mode
  *  @return -
  */
@@ -212,7 +260,7 @@ void doAutoFill(Board* userBoard, List* undoList, int* mode){
  *
  *  This function validates the user's input for generate, and call generate or prints error respectively
  *  @param userBoard - the user's board
- *  @param list - the doubly linked list which stores the moves
+ *  @param list - the undo log which stores the moves
  *  @param first - the first field the user sent to the command
  *  @param second - the second field the user sent to the command
  *  @return -
@@ -254,7 +302,7 @@ void doGenerate(Board* userBoard, List* undoList, char* first, char* second){
  */
 void doHint(Board* userBoard, char* first,char* second){
 	int x,y,boardsize, solved;
-	Board* fullBoard;
+	Snapshot* snapshot;
 	x = atoi(first);
 	y = atoi(second);
 	boardsize = userBoard->boardsize;
@@ -270,21 +318,21 @@ void doHint(Board* userBoard, char* first,char* second){
 	}
 	else
 	{
-		if (userBoard->cells[y-1][x-1].fixed==1)
+		if (userBoard->fixed[CELL(userBoard,y-1,x-1)]==1)
 			printf("Error: cell is fixed\n");
-		else if (userBoard->cells[y-1][x-1].value!=0)
+		else if (userBoard->values[CELL(userBoard,y-1,x-1)]!=0)
 			printf("Error: cell already contains a value\n");
 		else
 		{
-			/*run ILP and get a solved board*/
-			fullBoard = copyBoard(userBoard);
-			solved = ilpSolve(fullBoard);
+			/*solve the board in place and take the hint from the solution*/
+			snapshot = takeSnapshot(userBoard);
+			solved = solveBoard(userBoard);
 			if (solved==0)
 				printf("Error: board is unsolvable\n");
 			else
-				hint(fullBoard,y-1,x-1);
-			/*free the solved board's memory*/
-			destroyBoard(fullBoard);
+				hint(userBoard,y-1,x-1);
+			/*give the board back as it was*/
+			restoreSnapshot(snapshot);
 		}
 	}
 
@@ -295,7 +343,7 @@ void doHint(Board* userBoard, char* first,char* second){
  *
  *  This function validates the user's input for set, and call set or prints error respectively
  *  @param userBoard - the user's board
- *  @param list - the doubly linked list which stores the moves
+ *  @param list - the undo log which stores the moves
  *  @param first - the first field the user sent to the command
  *  @param second - the second field the user sent to the command
  *  @param third - the third field the user sent to the command
@@ -356,7 +404,7 @@ void doMarkErrors(Board* userBoard, char* first, int* lastBoardMarkErrors){
  *
  *  This function call undo method, and prints respective message if the board solutions erroneous
  *  @param userBoard - the user's board
- *  @param list - the doubly linked list which stores the moves
+ *  @param list - the undo log which stores the moves
  *  @param printVal - whether print or not the undone moves
  *  @param mode - the current game mode
  *  @return -
@@ -379,6 +427,53 @@ void doUndo(Board* board, List* undoList, int printVal, int* mode){
 	}
 
 }
+/*
+ * doSolver
+ *
+ *  This function selects the engine which solves and counts boards, or prints error respectively
+ *  @param name - the engine's name
+ *  @return -
+ */
+void doSolver(char* name){
+	int i;
+	if(selectSolver(name))
+		printf("Solver: %s\n", getSolverName());
+	else
+	{
+		printf("Error: unknown solver, the solvers are:");
+		for(i=0; getEngineName(i)!=NULL; i++)
+			printf(" %s", getEngineName(i));
+		printf("\n");
+	}
+}
+
+/*
+ * doStats
+ *
+ *  This function prints the engine and the number of search nodes of the last solve or count
+ *  (and the nodes it skipped, if any), and the temporaries memory of the last command which had any
+ *  @return -
+ */
+void doStats(){
+	printf("Solver: %s, search nodes: %lu\n", getLastSolverName(), getSearchNodes());
+	if(getSkippedNodes()>0)
+		printf("Skipped nodes (backjumps and nogoods): %lu\n", getSkippedNodes());
+	if(arenaAllocations()>0)
+		printf("Command memory: %lu bytes in %lu allocations\n", arenaBytes(), arenaAllocations());
+}
+
+/*
+ * doDimacs
+ *
+ *  This function writes the board's CNF encoding to a file in DIMACS format
+ *  @param userBoard - the user's board
+ *  @param path - a pointer to the desired path
+ *  @return -
+ */
+void doDimacs(Board* userBoard, char* path){
+	satWriteDimacs(userBoard, path);
+}
+
 /*
  * setOptions
  *
@@ -390,19 +485,100 @@ void doUndo(Board* board, List* undoList, int printVal, int* mode){
  */
 void setOptions(Board *board, int row, int column)
 {
-
-	int k,boardsize;
+	int k,word,boardsize,words;
+	unsigned long freeDigits;
 	boardsize=board->boardsize;
-	for (k=1;k<=boardsize; k++)
+	words=board->wordsPerUnit;
+	for (word=0;word<words; word++)
 	{
-		if (isValid(board,row, column, k)==1)
+		/* the digits that are not used in the cell's row, column and box */
+		freeDigits = ~(board->rowDigits[row*words+word] | board->columnDigits[column*words+word]
+				| board->boxDigits[BOX(board,row,column)*words+word]);
+		for (k=word*WORDBITS+1; freeDigits!=0 && k<=boardsize; k++, freeDigits>>=1)
 		{
-			addOption(board->cells[row][column].options, k, boardsize);
-			board->cells[row][column].numOfOptions++;
+			if (freeDigits & 1UL)
+			{
+				addOption(board->options + CELL(board,row,column)*boardsize, k, boardsize);
+				board->numOfOptions[CELL(board,row,column)]++;
+			}
 		}
 	}
 }
 
+/*
+ * countOptions
+ *
+ *  This function counts the valid values of a cell, without storing them
+ *  @param board - the game board
+ *  @param row - cell's row
+ *  @param column - cell's column
+ *  @return - the number of values which are not used in the cell's row, column and box
+ */
+int countOptions(Board *board, int row, int column)
+{
+	int word,words,usedCount=0;
+	words=board->wordsPerUnit;
+	for (word=0;word<words; word++)
+		usedCount += bitCount(board->rowDigits[row*words+word] | board->columnDigits[column*words+word]
+				| board->boxDigits[BOX(board,row,column)*words+word]);
+	return board->boardsize - usedCount;
+}
+
+/*
+ * unitCell
+ *
+ *  This function returns the index of the i'th cell of a row, column or box
+ *  @param board - the game board
+ *  @param kind - 0 for a row, 1 for a column, 2 for a box
+ *  @param unit - the row's, column's or box's index
+ *  @param i - the cell's place in the unit (0..boardsize-1)
+ *  @return - the cell's index
+ */
+int unitCell(Board *board, int kind, int unit, int i)
+{
+	return board->geometry->unitCells[(kind*board->boardsize+unit)*board->boardsize+i];
+}
+
+/*
+ * setCellValue
+ *
+ *  This function sets a value in a cell and keeps the digits bitsets and the digits counters of the cell's
+ *  row, column and box, and the board's filled cells count, updated. every change of a cell's value has to
+ *  be done by this function.
+ *  @param board - the game board
+ *  @param row - cell's row
+ *  @param column - cell's column
+ *  @param value - the new value (0 empties the cell)
+ *  @return -
+ */
+void setCellValue(Board *board, int row, int column, int value)
+{
+	int kind,boardsize,words,prevValue,counter;
+	int *cellUnits;
+	unsigned long *digits[3];
+
+	/* dimensions definition: */
+	boardsize=board->boardsize;
+	words=board->wordsPerUnit;
+	cellUnits=board->geometry->cellUnits+3*CELL(board,row,column);
+	digits[0]=board->rowDigits, digits[1]=board->columnDigits, digits[2]=board->boxDigits;
+
+	prevValue = board->values[CELL(board,row,column)];
+	if (prevValue==value)
+		return;
+	board->values[CELL(board,row,column)] = value;
+	board->filledNum += (value!=0) - (prevValue!=0);
+
+	for (kind=0;kind<3;kind++)
+	{
+		counter = (kind*boardsize+cellUnits[kind])*boardsize;
+		/* an erroneous board may hold the old value in another cell of the unit - then it is still used there */
+		if (prevValue!=0 && --board->unitCounts[counter+prevValue-1]==0)
+			digits[kind][cellUnits[kind]*words+DIGITWORD(prevValue)] &= ~DIGITBIT(prevValue);
+		if (value!=0 && board->unitCounts[counter+value-1]++==0)
+			digits[kind][cellUnits[kind]*words+DIGITWORD(value)] |= DIGITBIT(value);
+	}
+}
 
 /*
  * destroyBoard
@@ -414,25 +590,10 @@ void setOptions(Board *board, int row, int column)
  */
 void destroyBoard(Board *currentBoard)
 {
-	int k,l,size;
 	if(currentBoard){
-		size = currentBoard->boardsize;
-		for(k=0;k<size;k++)
-		{
-			for(l=0;l<size;l++)
-			{
-				if(currentBoard->cells[k][l].options){
-					free(currentBoard->cells[k][l].options);
-					currentBoard->cells[k][l].options = NULL;
-				}
-			}
-			if(currentBoard->cells[k])
-			{
-				free(currentBoard->cells[k]);
-			}
-		}
-		if(currentBoard->cells)
-			free(currentBoard->cells);
+		if(currentBoard->storage)
+			free(currentBoard->storage);
+		releaseGeometry(currentBoard->geometry);
 		free(currentBoard);
 	}
 }
@@ -446,56 +607,77 @@ void destroyBoard(Board *currentBoard)
 Board* copyBoard(Board *currentBoard)
 {
 	Board *wholeBoard;
-	Cell **newBoard;
-	int i,l;
-	int k,n,m,size;
 
-	size = currentBoard->boardsize, n=currentBoard->n, m=currentBoard->m;
-	wholeBoard = malloc(sizeof(Board));
-	if(!wholeBoard)
-	{
-		printf("Error: malloc has failed\n");
-		exit(0);
-		return NULL;
-	}
-	newBoard = malloc(size*sizeof(Cell *));
-	if(!newBoard)
-	{
-		printf("Error: malloc has failed\n");
-		exit(0);
-		return NULL;
-	}
+	/* the board creation - same dimensions, hence the same storage layout */
+	wholeBoard = init(currentBoard->n, currentBoard->m);
+	/* the cells are kept in one block, so a single copy is enough */
+	memcpy(wholeBoard->storage, currentBoard->storage, currentBoard->storageSize);
+	wholeBoard->markErrors = currentBoard->markErrors;
+	wholeBoard->filledNum = currentBoard->filledNum;
+	wholeBoard->errorsNum = currentBoard->errorsNum;
 
-	/* the cells creation */
-	for(i=0;i<size;i++)
-	{
-		newBoard[i] = malloc(sizeof(Cell) *size);
-		if(!newBoard[i])
-			{
-				printf("Error: malloc has failed\n");
-				exit(0);
-				return NULL;
-			}
-	}
-	for(k=0;k<size;k++)
-	{
-		for(l=0;l<size;l++)
-		{
-			newBoard[k][l].value = currentBoard->cells[k][l].value;
-			newBoard[k][l].fixed = currentBoard->cells[k][l].fixed;
-			newBoard[k][l].error = currentBoard->cells[k][l].error;
-			newBoard[k][l].options = copyOption(currentBoard->cells[k][l].options,size);
-			newBoard[k][l].numOfOptions = currentBoard->cells[k][l].numOfOptions;
-		}
-	}
+	return wholeBoard;
+}
 
-	/* the board creation */
-	wholeBoard->boardsize = size;
-	wholeBoard->cells = newBoard;
-	wholeBoard->n = n;
-	wholeBoard->m = m;
+/*
+ * takeSnapshot
+ *
+ *  This function takes a snapshot of the board's values. the board can then be solved in place, and
+ *  restoreSnapshot gives it back as it was. the snapshot is kept in the command's arena.
+ *  @param board - pointer to board
+ *  @return - the snapshot
+ */
+Snapshot* takeSnapshot(Board *board)
+{
+	int cell, cellsNum=board->boardsize*board->boardsize;
+	size_t mark = arenaMark();
+	Snapshot *snapshot = arenaAlloc(sizeof(Snapshot));
+	snapshot->mark = mark;
+	snapshot->board = board;
+	snapshot->emptyNum = 0;
+	snapshot->emptyCells = arenaAlloc((cellsNum-board->filledNum)*sizeof(int));
+	for(cell=0; cell<cellsNum; cell++)
+		if(board->values[cell]==0)
+			snapshot->emptyCells[snapshot->emptyNum++] = cell;
+	return snapshot;
+}
 
-	return wholeBoard;
+/*
+ * restoreSnapshot
+ *
+ *  This function empties the cells which were empty when the snapshot was taken, and gives the snapshot's
+ *  memory back to the arena (the snapshots have to be restored in the reverse order of taking them)
+ *  @param snapshot - the snapshot
+ *  @return -
+ */
+void restoreSnapshot(Snapshot *snapshot)
+{
+	int i, boardsize=snapshot->board->boardsize;
+	for(i=0; i<snapshot->emptyNum; i++)
+		setCellValue(snapshot->board, snapshot->emptyCells[i]/boardsize, snapshot->emptyCells[i]%boardsize, 0);
+	arenaRewind(snapshot->mark);
+}
+
+/*
+ * setBoardStorage
+ *
+ *  This function sets all values of an exisiting board from a copy of its storage block (see copyBoard),
+ *  and recounts its filled and erroneous cells
+ *  @param board - pointer to board
+ *  @param storage - the copy of the block
+ *  @return -
+ */
+void setBoardStorage(Board *board, const void *storage)
+{
+	int i, cellsNum=board->boardsize*board->boardsize;
+	memcpy(board->storage, storage, board->storageSize);
+	board->filledNum = 0;
+	board->errorsNum = 0;
+	for (i=0; i<cellsNum; i++)
+	{
+		board->filledNum += board->values[i]!=0;
+		board->errorsNum += board->error[i];
+	}
 }
 
 /*
@@ -507,20 +689,10 @@ Board* copyBoard(Board *currentBoard)
  */
 void resetBoard(Board *board)
 {
-	int k,l,size;
-	size = board->boardsize;
-
-	for(k=0;k<size;k++)
-	{
-		for(l=0;l<size;l++)
-		{
-			board->cells[k][l].value = 0;
-			board->cells[k][l].fixed = 0;
-			board->cells[k][l].error = 0;
-			resetOption(board->cells[k][l].options,size);
-			board->cells[k][l].numOfOptions = 0;
-		}
-	}
+	/* all the default values are zeros */
+	memset(board->storage, 0, board->storageSize);
+	board->filledNum = 0;
+	board->errorsNum = 0;
 }
 
 /*
@@ -532,15 +704,7 @@ void resetBoard(Board *board)
  */
 int isBoardFull(Board *currentBoard)
 {
-	int i, j;
-	int size = currentBoard->boardsize;
-	/* check that each one of the cells is not empty */
-	for (i =0; i<size; i++)
-		for (j =0; j<size; j++)
-			if(currentBoard->cells[i][j].value==0)
-				return 0;
-
-	return 1;
+	return currentBoard->filledNum == currentBoard->boardsize*currentBoard->boardsize;
 }
 
 /*
@@ -552,62 +716,13 @@ int isBoardFull(Board *currentBoard)
  */
 int isBoardEmpty(Board *currentBoard)
 {
-	int i, j;
-	int size = currentBoard->boardsize;
-
-	for (i =0; i<size; i++)
-		for (j =0; j<size; j++)
-			if(currentBoard->cells[i][j].value!=0)
-				return 0;
-
-	return 1;
+	return currentBoard->filledNum == 0;
 }
 
 /* End of public methods */
 
 /* Private methods: */
 
-/*
- * copyOption
- *
- *  This function copies an options array to a new location in memory (inc. allocation)
- *  @param options - pointer to the options array
- *  @param size - size of array
- *  @return - the new array's pointer
- */
-int* copyOption(int *options, int size)
-{
-	int k;
-	int* newOptions = calloc(size,sizeof(int));
-	if(!newOptions)
-	{
-		printf("Error: calloc has failed\n");
-		exit(0);
-		return NULL;
-	}
-	for(k=0;k<size;k++){
-		newOptions[k] = options[k];
-	}
-
-	return newOptions;
-}
-
-/*
- * resetOption
- *
- *  This function resets an options array
- *  @param fromOptions - pointer to the copied options array
- *  @param size - size of array
- *  @return -
- */
-void resetOption(int *options, int size)
-{
-	int k;
-	for(k=0;k<size;k++){
-		options[k] = 0;
-	}
-}
-
 /*
  * printArray
  *
@@ -627,6 +742,22 @@ void printArray(int *arr, int size)
 	printf("\n");
 }
 
+/*
+ * bitCount
+ *
+ *  This function counts the bits which are set in a word
+ *  @param word - the word
+ *  @return - number of set bits
+ */
+int bitCount(unsigned long word)
+{
+	int count=0;
+	/* every iteration clears the lowest set bit */
+	for (; word!=0; count++)
+		word &= word-1;
+	return count;
+}
+
 /*
  * addOption
  *
@@ -666,6 +797,23 @@ void removeOption(int *options, int index, int boardsize)
 	options[boardsize-1]=0;
 }
 
+/*
+ * printSolution
+ *
+ *  This function is the callback of print_solutions: it prints a solution while it is in the board.
+ *  data - the number of solutions which are left to print (0 = no limit)
+ *  returns 0 in order to stop the enumeration after the last one.
+ */
+int printSolution(Board* board, void* data)
+{
+	unsigned long *left = data;
+	printBoard(board);
+	if(*left==0)
+		return 1;
+	(*left)--;
+	return *left>0;
+}
+
 /* End of private methods */
 
 /* Private methods: */
@@ -27,7 +27,7 @@ void doSave(Board* board, char *path, int gameMode);
  *  This function validate the path it gets, and init the board from the file respectively
  *  @param path - a pointer to the desired path
  *  @param userBoard - the user's board
- *  @param list - the doubly linked list which stores the moves
+ *  @param list - the undo log which stores the moves
  *  @param mode - the current game mode
  *  @param currentMarkErrors - the current mark errors field
  *  @return -
@@ -40,7 +40,7 @@ void doSolve(char *path, Board** userBoard, List** undoList,int* mode, int curre
  *  This function validate the path it gets, and init the board from the file respectively
  *  @param path - a pointer to the desired path
  *  @param userBoard - the user's board
- *  @param list - the doubly linked list which stores the moves
+ *  @param list - the undo log which stores the moves
  *  @param mode - the current game mode
  *  @return -
  */
@@ -60,16 +60,27 @@ void doValidate(Board* board);
  *
  *  This function validates whether the board is erroneous or not, if not - gets the number of solutions and prints it
  *  @param userBoard - the user's board
+ *  @param limit - the field the user sent to the command: the number of solutions to stop at (NULL for none)
  *  @return -
  */
-void doNumSolutions(Board* board);
+void doNumSolutions(Board* board, char* limit);
+
+/*
+ * doPrintSolutions
+ *
+ *  This function validates whether the board is erroneous or not, if not - prints its solutions, one board after the other
+ *  @param userBoard - the user's board
+ *  @param limit - the field the user sent to the command: the number of solutions to stop at (NULL for none)
+ *  @return -
+ */
+void doPrintSolutions(Board* board, char* limit);
 
 /*
  * doAutoFill
  *
  *  This function validates whether the board is erroneous or not, if not - autofill it and check if the board is solved
  *  @param userBoard - the user's board
- *  @param list - the doubly linked list which stores the moves
+ *  @param list - the undo log which stores the moves
  *  @param mode - the current game mode
  *  @return -
  */
@@ -80,7 +91,7 @@ void doAutoFill(Board* board, List* undoList, int* mode);
  *
  *  This function validates the user's input for generate, and call generate or prints error respectively
  *  @param userBoard - the user's board
- *  @param list - the doubly linked list which stores the moves
+ *  @param list - the undo log which stores the moves
  *  @param first - the first field the user sent to the command
  *  @param second - the second field the user sent to the command
  *  @return -
@@ -114,7 +125,7 @@ void doMarkErrors(Board* userBoard, char* first, int* lastBoardMarkErrors);
  *
  *  This function validates the user's input for set, and call set or prints error respectively
  *  @param userBoard - the user's board
- *  @param list - the doubly linked list which stores the moves
+ *  @param list - the undo log which stores the moves
  *  @param first - the first field the user sent to the command
  *  @param second - the second field the user sent to the command
  *  @param third - the third field the user sent to the command
@@ -128,13 +139,41 @@ void doSet(Board* userBoard, List* undoList, char* first,char* second, char* thi
  *
  *  This function call undo method, and prints respective message if the board solutions erroneous
  *  @param userBoard - the user's board
- *  @param list - the doubly linked list which stores the moves
+ *  @param list - the undo log which stores the moves
  *  @param printVal - whether print or not the undone moves
  *  @param mode - the current game mode
  *  @return -
  */
 void doUndo(Board* board, List* undoList, int printVal, int* mode);
 
+/*
+ * doSolver
+ *
+ *  This function selects the engine which solves and counts boards, or prints error respectively
+ *  @param name - the engine's name
+ *  @return -
+ */
+void doSolver(char* name);
+
+/*
+ * doStats
+ *
+ *  This function prints the engine and the number of search nodes of the last solve or count
+ *  (and the nodes it skipped, if any), and the temporaries memory of the last command which had any
+ *  @return -
+ */
+void doStats();
+
+/*
+ * doDimacs
+ *
+ *  This function writes the board's CNF encoding to a file in DIMACS format
+ *  @param userBoard - the user's board
+ *  @param path - a pointer to the desired path
+ *  @return -
+ */
+void doDimacs(Board* userBoard, char* path);
+
 /*
  * setOptions
  *
@@ -146,6 +185,43 @@ void doUndo(Board* board, List* undoList, int printVal, int* mode);
  */
 void setOptions(Board *board, int row, int column);
 
+/*
+ * countOptions
+ *
+ *  This function counts the valid values of a cell, without storing them
+ *  @param board - the game board
+ *  @param row - cell's row
+ *  @param column - cell's column
+ *  @return - the number of values which are not used in the cell's row, column and box
+ */
+int countOptions(Board *board, int row, int column);
+
+/*
+ * unitCell
+ *
+ *  This function returns the index of the i'th cell of a row, column or box
+ *  @param board - the game board
+ *  @param kind - 0 for a row, 1 for a column, 2 for a box
+ *  @param unit - the row's, column's or box's index
+ *  @param i - the cell's place in the unit (0..boardsize-1)
+ *  @return - the cell's index
+ */
+int unitCell(Board *board, int kind, int unit, int i);
+
+/*
+ * setCellValue
+ *
+ *  This function sets a value in a cell and keeps the digits bitsets and the digits counters of the cell's
+ *  row, column and box, and the board's filled cells count, updated. every change of a cell's value has to
+ *  be done by this function.
+ *  @param board - the game board
+ *  @param row - cell's row
+ *  @param column - cell's column
+ *  @param value - the new value (0 empties the cell)
+ *  @return -
+ */
+void setCellValue(Board *board, int row, int column, int value);
+
 /*
  * destroyBoard
  *
@@ -165,6 +241,37 @@ void destroyBoard(Board *currentBoard);
  */
 Board* copyBoard(Board *currentBoard);
 
+/*
+ * takeSnapshot
+ *
+ *  This function takes a snapshot of the board's values. the board can then be solved in place, and
+ *  restoreSnapshot gives it back as it was. the snapshot is kept in the command's arena.
+ *  @param board - pointer to board
+ *  @return - the snapshot
+ */
+Snapshot* takeSnapshot(Board *board);
+
+/*
+ * restoreSnapshot
+ *
+ *  This function empties the cells which were empty when the snapshot was taken, and gives the snapshot's
+ *  memory back to the arena (the snapshots have to be restored in the reverse order of taking them)
+ *  @param snapshot - the snapshot
+ *  @return -
+ */
+void restoreSnapshot(Snapshot *snapshot);
+
+/*
+ * setBoardStorage
+ *
+ *  This function sets all values of an exisiting board from a copy of its storage block (see copyBoard),
+ *  and recounts its filled and erroneous cells
+ *  @param board - pointer to board
+ *  @param storage - the copy of the block
+ *  @return -
+ */
+void setBoardStorage(Board *board, const void *storage);
+
 /*
  * resetBoard
  *
@@ -0,0 +1,372 @@
+/*
+ * Parallel Module
+ *
+ *  This module counts the solutions of a board with several threads. The top levels of the search tree
+ *  are split into tasks, the tasks are spread over the threads' queues, and a thread which has finished
+ *  its own queue steals tasks from the other threads (work stealing). Each thread works on its own
+ *  copy of the board. The subtrees are counted by the engine's own counter (the backtracking one, or the
+ *  classic one for 9x9 boards).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "game.h"
+#include "solver.h"
+#include "mainAux.h"
+#include "parallel.h"
+
+#define TASKS_PER_THREAD 16 /* the search tree is split until there are that many tasks for every thread */
+#define MAX_SPLIT_DEPTH 8 /* the search tree is never split deeper than that */
+
+/* The tasks struct: every task is a subtree of the search, described by the assignments which lead to it.
+ * the assignments of task t are cells[t*MAX_SPLIT_DEPTH + i], values[t*MAX_SPLIT_DEPTH + i] for i<depths[t] */
+typedef struct tasks {
+	int *cells;
+	int *values;
+	int *depths;
+	int num;
+	int capacity;
+} Tasks;
+
+/* The worker struct: a counting thread, with its queue of task indexes. the owner takes tasks from the end
+ * of the queue and other threads steal from its beginning, both under the lock */
+typedef struct worker {
+	pthread_t thread;
+	pthread_mutex_t lock;
+	int *queue;
+	int first;
+	int last;
+	Board *board; /* the thread's own copy of the board */
+	Tasks *tasks;
+	struct worker *workers; /* all the workers - for stealing */
+	int workersNum;
+	int id;
+	unsigned long (*countTask)(Board *board, unsigned long *nodes); /* the engine's counter */
+	unsigned long count;
+	unsigned long nodes;
+} Worker;
+
+static int countingThreads = 1; /* number of threads used for counting */
+
+/* private methods declaration: */
+Tasks* initTasks();
+void destroyTasks(Tasks *tasks);
+void addTask(Tasks *tasks, Tasks *from, int index, int cell, int value);
+Tasks* splitTasks(Board *board, int target);
+void applyTask(Board *board, Tasks *tasks, int index, int apply);
+int takeTask(Worker *worker);
+int stealTask(Worker *worker);
+void* runWorker(void *data);
+
+/* Public methods: */
+
+/*
+ * setCountingThreads
+ *
+ *  This function sets the number of threads used for counting solutions
+ *  @param threads - number of threads (1 = count in the calling thread)
+ *  @return -
+ */
+void setCountingThreads(int threads)
+{
+	countingThreads = threads>0 ? threads : 1;
+}
+
+/*
+ * getCountingThreads
+ *
+ *  This function returns the number of threads used for counting solutions
+ *  @return - number of threads
+ */
+int getCountingThreads()
+{
+	return countingThreads;
+}
+
+/*
+ * parallelCount
+ *
+ *  This function counts the solutions of a board which has no errors with the counting threads.
+ *  the board is not changed.
+ *  @param board - the board
+ *  @param count - the engine's counter, which counts all the solutions of a task's board copy and adds its
+ *                 search nodes to nodes. the threads call it together, so it cannot keep any global state
+ *  @param nodes - pointer to a counter of search nodes, increased by the nodes all the threads visit
+ *  @return - number of solutions
+ */
+unsigned long parallelCount(Board *board, unsigned long (*count)(Board *board, unsigned long *nodes), unsigned long *nodes)
+{
+	int i;
+	unsigned long solutions=0;
+	Tasks *tasks;
+	Worker *workers;
+
+	tasks = splitTasks(board, countingThreads*TASKS_PER_THREAD);
+	workers = malloc(countingThreads*sizeof(Worker));
+	if(!workers)
+	{
+		printf("Error: malloc has failed\n");
+		exit(0);
+	}
+
+	/* every worker gets its own board copy and every countingThreads'th task */
+	for(i=0;i<countingThreads;i++)
+	{
+		workers[i].queue = malloc((tasks->num+1)*sizeof(int));
+		if(!workers[i].queue)
+		{
+			printf("Error: malloc has failed\n");
+			exit(0);
+		}
+		workers[i].first = workers[i].last = 0;
+		workers[i].board = copyBoard(board);
+		workers[i].tasks = tasks;
+		workers[i].workers = workers;
+		workers[i].workersNum = countingThreads;
+		workers[i].id = i;
+		workers[i].countTask = count;
+		workers[i].count = 0;
+		workers[i].nodes = 0;
+		pthread_mutex_init(&workers[i].lock, NULL);
+	}
+	for(i=0;i<tasks->num;i++)
+		workers[i%countingThreads].queue[workers[i%countingThreads].last++] = i;
+
+	for(i=0;i<countingThreads;i++)
+	{
+		if(pthread_create(&workers[i].thread, NULL, runWorker, &workers[i])!=0)
+		{
+			printf("Error: pthread_create has failed\n");
+			exit(0);
+		}
+	}
+
+	/* wait for all the workers and sum their counts */
+	for(i=0;i<countingThreads;i++)
+	{
+		pthread_join(workers[i].thread, NULL);
+		solutions += workers[i].count;
+		(*nodes) += workers[i].nodes;
+	}
+
+	for(i=0;i<countingThreads;i++)
+	{
+		pthread_mutex_destroy(&workers[i].lock);
+		destroyBoard(workers[i].board);
+		free(workers[i].queue);
+	}
+	free(workers);
+	destroyTasks(tasks);
+	return solutions;
+}
+
+/* End of public methods */
+
+/* Private methods: */
+
+/*
+ * initTasks
+ *
+ *  This function allocates an empty tasks list
+ */
+Tasks* initTasks()
+{
+	Tasks *tasks = malloc(sizeof(Tasks));
+	if(!tasks)
+	{
+		printf("Error: malloc has failed\n");
+		exit(0);
+	}
+	tasks->num = 0;
+	tasks->capacity = 0;
+	tasks->cells = NULL;
+	tasks->values = NULL;
+	tasks->depths = NULL;
+	return tasks;
+}
+
+/*
+ * destroyTasks
+ *
+ *  This function frees a tasks list
+ */
+void destroyTasks(Tasks *tasks)
+{
+	free(tasks->cells);
+	free(tasks->values);
+	free(tasks->depths);
+	free(tasks);
+}
+
+/*
+ * addTask
+ *
+ *  This function adds a task to the list: the assignments of task "index" in "from", and one more
+ *  assignment if cell is not -1
+ */
+void addTask(Tasks *tasks, Tasks *from, int index, int cell, int value)
+{
+	int depth;
+	if(tasks->num==tasks->capacity)
+	{
+		tasks->capacity = tasks->capacity ? 2*tasks->capacity : 64;
+		tasks->cells = realloc(tasks->cells, tasks->capacity*MAX_SPLIT_DEPTH*sizeof(int));
+		tasks->values = realloc(tasks->values, tasks->capacity*MAX_SPLIT_DEPTH*sizeof(int));
+		tasks->depths = realloc(tasks->depths, tasks->capacity*sizeof(int));
+		if(!tasks->cells || !tasks->values || !tasks->depths)
+		{
+			printf("Error: realloc has failed\n");
+			exit(0);
+		}
+	}
+	depth = from->depths[index];
+	memcpy(tasks->cells + tasks->num*MAX_SPLIT_DEPTH, from->cells + index*MAX_SPLIT_DEPTH, depth*sizeof(int));
+	memcpy(tasks->values + tasks->num*MAX_SPLIT_DEPTH, from->values + index*MAX_SPLIT_DEPTH, depth*sizeof(int));
+	if(cell!=-1)
+	{
+		tasks->cells[tasks->num*MAX_SPLIT_DEPTH + depth] = cell;
+		tasks->values[tasks->num*MAX_SPLIT_DEPTH + depth] = value;
+		depth++;
+	}
+	tasks->depths[tasks->num] = depth;
+	tasks->num++;
+}
+
+/*
+ * splitTasks
+ *
+ *  This function splits the top of the search tree, level after level, until there are at least "target"
+ *  tasks. in every level each task is split over the options of its most constrained empty cell.
+ *  tasks which fill the whole board stay as they are, and tasks with a cell that has no options are dropped.
+ */
+Tasks* splitTasks(Board *board, int target)
+{
+	int t, cell, best, bestOptions, options, value, depth, split=1, size, cellsNum;
+	Tasks *current, *next;
+	Board *scratch = copyBoard(board);
+	size = board->boardsize;
+	cellsNum = size*size;
+
+	/* the root task has no assignments */
+	current = initTasks();
+	current->depths = malloc(sizeof(int));
+	current->cells = malloc(MAX_SPLIT_DEPTH*sizeof(int));
+	current->values = malloc(MAX_SPLIT_DEPTH*sizeof(int));
+	if(!current->depths || !current->cells || !current->values)
+	{
+		printf("Error: malloc has failed\n");
+		exit(0);
+	}
+	current->depths[0] = 0;
+	current->num = current->capacity = 1;
+
+	for(depth=0; depth<MAX_SPLIT_DEPTH && current->num<target && split; depth++)
+	{
+		next = initTasks();
+		split = 0;
+		for(t=0;t<current->num;t++)
+		{
+			applyTask(scratch, current, t, 1);
+			best = -1, bestOptions = size+1;
+			for(cell=0;cell<cellsNum && bestOptions>0;cell++)
+			{
+				if(scratch->values[cell]!=0)
+					continue;
+				options = countOptions(scratch, cell/size, cell%size);
+				if(options<bestOptions)
+					best = cell, bestOptions = options;
+			}
+			if(best==-1) /* a full board - one solution */
+				addTask(next, current, t, -1, 0);
+			else
+			{
+				for(value=1;value<=size && bestOptions>0;value++)
+					if(isValid(scratch, best/size, best%size, value))
+						addTask(next, current, t, best, value), split = 1;
+			}
+			applyTask(scratch, current, t, 0);
+		}
+		destroyTasks(current);
+		current = next;
+	}
+	destroyBoard(scratch);
+	return current;
+}
+
+/*
+ * applyTask
+ *
+ *  This function sets the assignments of a task in the board (apply=1), or empties their cells again (apply=0)
+ */
+void applyTask(Board *board, Tasks *tasks, int index, int apply)
+{
+	int i, cell, size=board->boardsize;
+	for(i=tasks->depths[index]-1;i>=0;i--)
+	{
+		cell = tasks->cells[index*MAX_SPLIT_DEPTH + i];
+		setCellValue(board, cell/size, cell%size, apply ? tasks->values[index*MAX_SPLIT_DEPTH + i] : 0);
+	}
+}
+
+/*
+ * takeTask
+ *
+ *  This function takes the last task of the worker's own queue. returns -1 if the queue is empty.
+ */
+int takeTask(Worker *worker)
+{
+	int task = -1;
+	pthread_mutex_lock(&worker->lock);
+	if(worker->first<worker->last)
+		task = worker->queue[--worker->last];
+	pthread_mutex_unlock(&worker->lock);
+	return task;
+}
+
+/*
+ * stealTask
+ *
+ *  This function takes the first task of another worker's queue. returns -1 if all the queues are empty.
+ */
+int stealTask(Worker *worker)
+{
+	int i, task = -1;
+	Worker *victim;
+	for(i=1;i<worker->workersNum && task==-1;i++)
+	{
+		victim = &worker->workers[(worker->id+i)%worker->workersNum];
+		pthread_mutex_lock(&victim->lock);
+		if(victim->first<victim->last)
+			task = victim->queue[victim->first++];
+		pthread_mutex_unlock(&victim->lock);
+	}
+	return task;
+}
+
+/*
+ * runWorker
+ *
+ *  This function is the thread's main function: counts the solutions of its own tasks, then of stolen ones,
+ *  until there are no tasks left. no task is created while the threads run, so an empty scan means done.
+ */
+void* runWorker(void *data)
+{
+	int task;
+	Worker *worker = (Worker*)data;
+	while(1)
+	{
+		task = takeTask(worker);
+		if(task==-1)
+			task = stealTask(worker);
+		if(task==-1)
+			break;
+		applyTask(worker->board, worker->tasks, task, 1);
+		worker->count += worker->countTask(worker->board, &worker->nodes);
+		applyTask(worker->board, worker->tasks, task, 0);
+	}
+	return NULL;
+}
+
+/* End of private methods */
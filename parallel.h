@@ -0,0 +1,46 @@
+/*
+ * Parallel Module
+ *
+ *  This module counts the solutions of a board with several threads. The top levels of the search tree
+ *  are split into tasks, the tasks are spread over the threads' queues, and a thread which has finished
+ *  its own queue steals tasks from the other threads (work stealing). Each thread works on its own
+ *  copy of the board. The subtrees are counted by the engine's own counter (the backtracking one, or the
+ *  classic one for 9x9 boards).
+ */
+
+#ifndef PARALLEL_H_
+#define PARALLEL_H_
+
+#include "game.h"
+
+/*
+ * setCountingThreads
+ *
+ *  This function sets the number of threads used for counting solutions
+ *  @param threads - number of threads (1 = count in the calling thread)
+ *  @return -
+ */
+void setCountingThreads(int threads);
+
+/*
+ * getCountingThreads
+ *
+ *  This function returns the number of threads used for counting solutions
+ *  @return - number of threads
+ */
+int getCountingThreads();
+
+/*
+ * parallelCount
+ *
+ *  This function counts the solutions of a board which has no errors with the counting threads.
+ *  the board is not changed.
+ *  @param board - the board
+ *  @param count - the engine's counter, which counts all the solutions of a task's board copy and adds its
+ *                 search nodes to nodes. the threads call it together, so it cannot keep any global state
+ *  @param nodes - pointer to a counter of search nodes, increased by the nodes all the threads visit
+ *  @return - number of solutions
+ */
+unsigned long parallelCount(Board *board, unsigned long (*count)(Board *board, unsigned long *nodes), unsigned long *nodes);
+
+#endif /* PARALLEL_H_ */
@@ -14,6 +14,7 @@
 #include "tools.h"
 #include "mainAux.h"
 #include "ILPSolver.h"
+#include "arena.h"
 
 #define MAXLINELEN 255 /* A constant for maximum command length */
 /* private methods declaration: */
@@ -55,7 +56,7 @@ void read()
 
 	while(1)
 	{
-		if(string[0]!='\0' && (inputValidation==1 || inputValidation==2)){
+		if(string[0]!=NULL && (inputValidation==1 || inputValidation==2)){
 			if ((strcmp(string[0],"set")==0) && string[1]!=NULL && string[2]!=NULL && string[3]!=NULL && (mode==1 || mode==2)) /*available in solve or edit*/
 				{ doSet(userBoard,undoList, string[1], string[2], string[3],&mode); }
 			else if (strcmp(string[0],"hint")==0 && string[1]!=NULL && string[2]!=NULL && mode==1) /*available only in solve*/
@@ -81,13 +82,22 @@ void read()
 			else if (strcmp(string[0],"save")==0 && string[1]!=NULL && (mode==1 || mode==2)) /*available in solve or edit*/
 				{ doSave(userBoard, string[1], mode); }
 			else if (strcmp(string[0],"num_solutions")==0 && (mode==1 || mode==2))/*available in solve or edit*/
-				{ doNumSolutions(userBoard); }
+				{ doNumSolutions(userBoard, string[1]); }
+			else if (strcmp(string[0],"print_solutions")==0 && (mode==1 || mode==2))/*available in solve or edit*/
+				{ doPrintSolutions(userBoard, string[1]); }
 			else if ((strcmp(string[0],"autofill")==0) && (mode==1)) /*available only in solve*/
 				{ doAutoFill(userBoard, undoList, &mode); }
+			else if (strcmp(string[0],"solver")==0 && string[1]!=NULL) /*available in every mode*/
+				{ doSolver(string[1]); }
+			else if (strcmp(string[0],"stats")==0) /*available in every mode*/
+				{ doStats(); }
+			else if (strcmp(string[0],"dimacs")==0 && string[1]!=NULL && (mode==1 || mode==2)) /*available in solve or edit*/
+				{ doDimacs(userBoard, string[1]); }
 			else if (strcmp(string[0],"exit")==0) /*available in every mode*/
 				{ exitGame(userBoard, undoList); }
 			else { printf("Error: invalid command\n"); }
 		}
+		arenaRelease(); /* the command's temporaries */
 		if (exit)/*if got EOF in the middle of the command*/
 			exitGame(userBoard, undoList);
 		printf("Enter your command:\n");
@@ -0,0 +1,236 @@
+/*
+ * Propagation Module
+ *
+ *  This module fills the cells whose values are forced, before and during the search:
+ *  a naked single is an empty cell which has only one valid value, and a hidden single is a value
+ *  which has only one empty cell in a row, column or box where it can be placed.
+ *  The singles are applied again and again until there are no more of them (fixpoint).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "game.h"
+#include "solver.h"
+#include "mainAux.h"
+#include "arena.h"
+#include "propagate.h"
+
+/* private methods declaration: */
+int unitHiddenSingle(Board *board, int kind, int unit, unsigned long *masks, int *cell, int *value);
+
+/* Public methods: */
+
+/*
+ * singleValue
+ *
+ *  This function checks whether an empty cell is a naked single
+ *  @param board - the game board
+ *  @param row - cell's row
+ *  @param column - cell's column
+ *  @return - the only valid value of the cell, 0 if it has no valid value or more than one
+ */
+int singleValue(Board *board, int row, int column)
+{
+	int value;
+	if (countOptions(board, row, column)!=1)
+		return 0;
+	for (value=1; value<=board->boardsize; value++)
+		if (isValid(board, row, column, value))
+			return value;
+	return 0;
+}
+
+/*
+ * findHiddenSingle
+ *
+ *  This function looks for a value which has only one empty cell in some row, column or box where it can
+ *  be placed. it also finds the opposite case - a value which is missing in a unit and cannot be placed
+ *  anywhere in it, so the board is unsolvable.
+ *  @param board - the game board
+ *  @param masks - work space of (boardsize*boardsize+2)*wordsPerUnit words
+ *  @param cell - pointer to the found cell's index
+ *  @param value - pointer to the found value
+ *  @return - 1 if a hidden single was found, -1 if some value cannot be placed in its unit, 0 otherwise
+ */
+int findHiddenSingle(Board *board, unsigned long *masks, int *cell, int *value)
+{
+	/* the valid values of every empty cell, found once for all the units */
+	fillFreeDigits(board, masks);
+	return findUnitsHiddenSingle(board, masks, cell, value);
+}
+
+/*
+ * fillFreeDigits
+ *
+ *  This function finds the valid values of every cell of the board, in the form which findUnitsHiddenSingle
+ *  reads: bit value-1 of the cell's wordsPerUnit words is set if the value is valid, and a filled cell has none.
+ *  @param board - the game board
+ *  @param masks - work space of (boardsize*boardsize+2)*wordsPerUnit words
+ *  @return -
+ */
+void fillFreeDigits(Board *board, unsigned long *masks)
+{
+	int index, word, words=board->wordsPerUnit, N=board->boardsize;
+	unsigned long *freeDigits=masks+2*words;
+	for (index=0; index<N*N; index++)
+		for (word=0; word<words; word++)
+			freeDigits[index*words+word] = board->values[index]!=0 ? 0 :
+					~(board->rowDigits[(index/N)*words+word] | board->columnDigits[(index%N)*words+word]
+					| board->boxDigits[BOX(board,index/N,index%N)*words+word]);
+}
+
+/*
+ * findUnitsHiddenSingle
+ *
+ *  This function is findHiddenSingle on masks whose valid values are already filled (by fillFreeDigits, and
+ *  kept updated since), so a search which updates them on every assignment does not find them again.
+ *  @param board - the game board
+ *  @param masks - work space of (boardsize*boardsize+2)*wordsPerUnit words, with the valid values of the cells
+ *  @param cell - pointer to the found cell's index
+ *  @param value - pointer to the found value
+ *  @return - 1 if a hidden single was found, -1 if some value cannot be placed in its unit, 0 otherwise
+ */
+int findUnitsHiddenSingle(Board *board, unsigned long *masks, int *cell, int *value)
+{
+	int kind, unit, result;
+	/* rows, columns and boxes */
+	for (kind=0; kind<3; kind++)
+		for (unit=0; unit<board->boardsize; unit++)
+		{
+			result = unitHiddenSingle(board, kind, unit, masks, cell, value);
+			if (result!=0)
+				return result;
+		}
+	return 0;
+}
+
+/*
+ * propagateSingles
+ *
+ *  This function fills the naked and hidden singles of the board until there are none left.
+ *  the filled cells are recorded, so undoSingles can empty them again.
+ *  @param board - the game board
+ *  @param filled - array of boardsize*boardsize entries, gets the indexes of the filled cells
+ *  @param filledNum - pointer to the number of filled cells
+ *  @return - 0 if the board was found unsolvable on the way, 1 otherwise
+ */
+int propagateSingles(Board *board, int *filled, int *filledNum)
+{
+	int cell, value, changed=1, result=1, N=board->boardsize;
+	size_t mark = arenaMark();
+	unsigned long *masks = arenaAlloc((N*N+2)*board->wordsPerUnit*sizeof(unsigned long));
+
+	*filledNum = 0;
+	while (changed && result)
+	{
+		changed = 0;
+		/* naked singles - the cheap ones first */
+		for (cell=0; cell<N*N && result; cell++)
+		{
+			if (board->values[cell]!=0)
+				continue;
+			if (countOptions(board, cell/N, cell%N)==0)
+				result = 0;
+			else if ((value = singleValue(board, cell/N, cell%N))!=0)
+			{
+				setCellValue(board, cell/N, cell%N, value);
+				filled[(*filledNum)++] = cell;
+				changed = 1;
+			}
+		}
+		if (changed || !result)
+			continue;
+		result = findHiddenSingle(board, masks, &cell, &value);
+		if (result==1)
+		{
+			setCellValue(board, cell/N, cell%N, value);
+			filled[(*filledNum)++] = cell;
+			changed = 1;
+		}
+		result = (result!=-1);
+	}
+	arenaRewind(mark);
+	return result;
+}
+
+/*
+ * undoSingles
+ *
+ *  This function empties the cells which propagateSingles filled
+ *  @param board - the game board
+ *  @param filled - the indexes of the filled cells
+ *  @param filledNum - number of filled cells
+ *  @return -
+ */
+void undoSingles(Board *board, int *filled, int filledNum)
+{
+	int N=board->boardsize;
+	while (filledNum>0)
+	{
+		filledNum--;
+		setCellValue(board, filled[filledNum]/N, filled[filledNum]%N, 0);
+	}
+}
+
+/* End of public methods */
+
+/* Private methods: */
+
+/*
+ * unitHiddenSingle
+ *
+ *  This function looks for a hidden single in one unit: for every value it finds whether it can be placed
+ *  in no empty cell, in one, or in more (the masks "once" and "twice", bit value-1 as in the digits bitsets).
+ *  masks - the work space of findHiddenSingle, which holds the valid values of every cell after "twice".
+ *  returns 1 and the cell and value of a hidden single, -1 if a missing value cannot be placed, 0 otherwise.
+ */
+int unitHiddenSingle(Board *board, int kind, int unit, unsigned long *masks, int *cell, int *value)
+{
+	int i, word, bit, current, words=board->wordsPerUnit, N=board->boardsize;
+	unsigned long *once=masks, *twice=masks+words, *freeDigits, used, valid, single;
+
+	for (word=0; word<words; word++)
+		once[word] = twice[word] = 0;
+	for (i=0; i<N; i++)
+	{
+		freeDigits = masks + (2+unitCell(board, kind, unit, i))*words;
+		for (word=0; word<words; word++)
+		{
+			twice[word] |= once[word] & freeDigits[word];
+			once[word] |= freeDigits[word];
+		}
+	}
+
+	for (word=0; word<words; word++)
+	{
+		/* the bits of the values 1..N in this word */
+		valid = (N-word*(int)WORDBITS >= (int)WORDBITS) ? ~0UL : (1UL<<(N-word*(int)WORDBITS))-1;
+		if (kind==0)
+			used = board->rowDigits[unit*words+word];
+		else if (kind==1)
+			used = board->columnDigits[unit*words+word];
+		else
+			used = board->boxDigits[unit*words+word];
+		if (valid & ~used & ~once[word])
+			return -1;
+		single = valid & ~used & once[word] & ~twice[word];
+		if (single==0)
+			continue;
+		for (bit=0; !(single & 1UL); bit++)
+			single >>= 1;
+		*value = word*(int)WORDBITS+bit+1;
+		/* the only cell of the unit where the value is valid */
+		for (i=0; i<N; i++)
+		{
+			current = unitCell(board, kind, unit, i);
+			if (masks[(2+current)*words+word] & (1UL<<bit))
+			{
+				*cell = current;
+				return 1;
+			}
+		}
+	}
+	return 0;
+}
+
+/* End of private methods */
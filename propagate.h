@@ -0,0 +1,87 @@
+/*
+ * Propagation Module
+ *
+ *  This module fills the cells whose values are forced, before and during the search:
+ *  a naked single is an empty cell which has only one valid value, and a hidden single is a value
+ *  which has only one empty cell in a row, column or box where it can be placed.
+ *  The singles are applied again and again until there are no more of them (fixpoint).
+ */
+
+#ifndef PROPAGATE_H_
+#define PROPAGATE_H_
+
+#include "game.h"
+
+/*
+ * singleValue
+ *
+ *  This function checks whether an empty cell is a naked single
+ *  @param board - the game board
+ *  @param row - cell's row
+ *  @param column - cell's column
+ *  @return - the only valid value of the cell, 0 if it has no valid value or more than one
+ */
+int singleValue(Board *board, int row, int column);
+
+/*
+ * findHiddenSingle
+ *
+ *  This function looks for a value which has only one empty cell in some row, column or box where it can
+ *  be placed. it also finds the opposite case - a value which is missing in a unit and cannot be placed
+ *  anywhere in it, so the board is unsolvable.
+ *  @param board - the game board
+ *  @param masks - work space of (boardsize*boardsize+2)*wordsPerUnit words
+ *  @param cell - pointer to the found cell's index
+ *  @param value - pointer to the found value
+ *  @return - 1 if a hidden single was found, -1 if some value cannot be placed in its unit, 0 otherwise
+ */
+int findHiddenSingle(Board *board, unsigned long *masks, int *cell, int *value);
+
+/*
+ * fillFreeDigits
+ *
+ *  This function finds the valid values of every cell of the board, in the form which findUnitsHiddenSingle
+ *  reads: bit value-1 of the cell's wordsPerUnit words is set if the value is valid, and a filled cell has none.
+ *  @param board - the game board
+ *  @param masks - work space of (boardsize*boardsize+2)*wordsPerUnit words
+ *  @return -
+ */
+void fillFreeDigits(Board *board, unsigned long *masks);
+
+/*
+ * findUnitsHiddenSingle
+ *
+ *  This function is findHiddenSingle on masks whose valid values are already filled (by fillFreeDigits, and
+ *  kept updated since), so a search which updates them on every assignment does not find them again.
+ *  @param board - the game board
+ *  @param masks - work space of (boardsize*boardsize+2)*wordsPerUnit words, with the valid values of the cells
+ *  @param cell - pointer to the found cell's index
+ *  @param value - pointer to the found value
+ *  @return - 1 if a hidden single was found, -1 if some value cannot be placed in its unit, 0 otherwise
+ */
+int findUnitsHiddenSingle(Board *board, unsigned long *masks, int *cell, int *value);
+
+/*
+ * propagateSingles
+ *
+ *  This function fills the naked and hidden singles of the board until there are none left.
+ *  the filled cells are recorded, so undoSingles can empty them again.
+ *  @param board - the game board
+ *  @param filled - array of boardsize*boardsize entries, gets the indexes of the filled cells
+ *  @param filledNum - pointer to the number of filled cells
+ *  @return - 0 if the board was found unsolvable on the way, 1 otherwise
+ */
+int propagateSingles(Board *board, int *filled, int *filledNum);
+
+/*
+ * undoSingles
+ *
+ *  This function empties the cells which propagateSingles filled
+ *  @param board - the game board
+ *  @param filled - the indexes of the filled cells
+ *  @param filledNum - number of filled cells
+ *  @return -
+ */
+void undoSingles(Board *board, int *filled, int filledNum);
+
+#endif /* PROPAGATE_H_ */
@@ -0,0 +1,872 @@
+/*
+ * SAT Module
+ *
+ *  This module solves a sudoku board as a boolean satisfiability problem. The board is encoded in CNF -
+ *  variable cell*N+value is true iff the cell holds the value - and the formula is solved by a
+ *  conflict-driven clause-learning solver (watched literals, first-UIP learning, VSIDS and restarts).
+ *  The CNF can also be written in DIMACS format, for running it with other solvers.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "game.h"
+#include "solver.h"
+#include "mainAux.h"
+#include "sat.h"
+
+#define RESTART_BASE 100 /* conflicts between restarts are RESTART_BASE times the luby sequence */
+#define VAR_DECAY 0.95 /* the variables' activity decay on every conflict */
+#define MIN_WATCHES 4 /* initial size of a watch list */
+
+/* literals are 2*var for "var is true" and 2*var+1 for "var is false" */
+#define VAR(lit) ((lit)>>1)
+#define NOT(lit) ((lit)^1)
+
+/* The sat struct: the clauses are kept one after another in one literals array. the first
+ * originalNum clauses are the board's encoding, and the learnt clauses come after them.
+ * every clause of two literals or more is watched by its first two literals */
+typedef struct sat {
+	int varsNum;
+	int *lits;
+	int litsNum;
+	int litsCapacity;
+	int *clauseStart;
+	int *clauseSize;
+	int clausesNum;
+	int clausesCapacity;
+	int originalNum;
+	int unsat; /* the encoding has an empty clause, or a conflict was found on level 0 */
+	char *used; /* the variables which appear in the encoding */
+	int **watches; /* watches[lit] - the clauses that watch lit, visited when lit becomes false */
+	int *watchesNum;
+	int *watchesCapacity;
+	signed char *assigns; /* -1 unassigned, 0 false, 1 true */
+	char *polarity; /* the last value of every variable (phase saving) */
+	int *level;
+	int *reason; /* the clause which implied the variable (-1 for decisions and level 0 units) */
+	int *trail;
+	int trailNum;
+	int *trailLimits; /* the trail length where every decision level starts */
+	int decisionLevel;
+	int queueHead; /* trail entries before it were propagated */
+	double *activity;
+	double varInc;
+	int *heap; /* the unassigned variables, a max heap by activity */
+	int heapNum;
+	int *heapIndex; /* place of every variable in the heap (-1 if not in it) */
+	char *seen;
+	int *learnt;
+	unsigned long decisions;
+	unsigned long conflicts;
+} Sat;
+
+static unsigned long nodesCount = 0; /* decisions of the last run */
+
+/* private methods declaration: */
+Sat* buildSat(Board *board);
+Sat* initSat(int varsNum);
+void destroySat(Sat *sat);
+void addClause(Sat *sat, int *lits, int size);
+void addGroup(Sat *sat, int *group, int size);
+void attachClauses(Sat *sat);
+void watchClause(Sat *sat, int lit, int clause);
+int litValue(Sat *sat, int lit);
+void enqueue(Sat *sat, int lit, int reason);
+int propagate(Sat *sat);
+int analyze(Sat *sat, int conflict, int *backLevel);
+void cancelUntil(Sat *sat, int level);
+int searchSat(Sat *sat);
+unsigned long enumerateSat(Board *board, unsigned long limit, int (*onSolution)(Board *board, void *data), void *data);
+void fillSolution(Sat *sat, Board *board, int value);
+void bumpVar(Sat *sat, int var);
+void heapUp(Sat *sat, int i);
+void heapDown(Sat *sat, int i);
+void heapInsert(Sat *sat, int var);
+int heapPop(Sat *sat);
+unsigned long luby(int x);
+
+/* Public methods: */
+
+/*
+ * satSolve
+ *
+ *  This function finds a solution of the board and fills the board's empty cells with it.
+ *  the board is not changed if there is no solution.
+ *  @param board - the board to solve
+ *  @return - 1 if solved, 0 if the board is unsolvable
+ */
+int satSolve(Board *board)
+{
+	int solved=0;
+	Sat *sat = buildSat(board);
+
+	attachClauses(sat);
+	if (!sat->unsat)
+		solved = searchSat(sat);
+	if (solved)
+		fillSolution(sat, board, 1);
+	nodesCount = sat->decisions;
+	destroySat(sat);
+	return solved;
+}
+
+/*
+ * satCount
+ *
+ *  This function counts the solutions of the board: after every solution a clause which blocks it is
+ *  learnt, and the search goes on. the board is not changed.
+ *  @param board - the board
+ *  @param limit - stop counting after that many solutions (0 = count them all)
+ *  @return - number of solutions (at most limit)
+ */
+unsigned long satCount(Board *board, unsigned long limit)
+{
+	return enumerateSat(board, limit, NULL, NULL);
+}
+
+/*
+ * satEnumerate
+ *
+ *  This function goes over all the solutions of the board. for each solution the board's empty cells
+ *  are filled with it and the callback is called. after the callback the cells are emptied again.
+ *  @param board - the board
+ *  @param onSolution - called for every solution, returns 0 in order to stop the enumeration
+ *  @param data - passed to the callback
+ *  @return - number of solutions visited
+ */
+unsigned long satEnumerate(Board *board, int (*onSolution)(Board *board, void *data), void *data)
+{
+	return enumerateSat(board, 0, onSolution, data);
+}
+
+/*
+ * satWriteDimacs
+ *
+ *  This function writes the CNF of the board to a file in DIMACS format
+ *  @param board - the board
+ *  @param path - the file's path
+ *  @return - 1 if the file was written, 0 if not
+ */
+int satWriteDimacs(Board *board, char *path)
+{
+	int c, i, lit;
+	Sat *sat;
+	FILE *f = fopen(path, "w");
+	if (f == NULL)
+	{
+		printf("Error: File cannot be created or modified\n");
+		return 0;
+	}
+	sat = buildSat(board);
+	fprintf(f, "c sudoku board, blocks of %d rows and %d columns\n", board->m, board->n);
+	fprintf(f, "c variable (row*%d+column)*%d+value is true iff the cell holds the value\n",
+			board->boardsize, board->boardsize);
+	fprintf(f, "p cnf %d %d\n", sat->varsNum, sat->clausesNum);
+	for (c=0; c<sat->clausesNum; c++)
+	{
+		for (i=0; i<sat->clauseSize[c]; i++)
+		{
+			lit = sat->lits[sat->clauseStart[c]+i];
+			fprintf(f, "%d ", (lit&1) ? -(VAR(lit)+1) : VAR(lit)+1);
+		}
+		fprintf(f, "0\n");
+	}
+	fclose(f);
+	destroySat(sat);
+	return 1;
+}
+
+/*
+ * satNodesCount
+ *
+ *  This function returns the number of decisions of the last sat run
+ *  @return - number of decisions
+ */
+unsigned long satNodesCount()
+{
+	return nodesCount;
+}
+
+/* End of public methods */
+
+/* Private methods: */
+
+/*
+ * buildSat
+ *
+ *  This function encodes the board: every empty cell has exactly one value, and every value which is
+ *  missing from a row, column or box is in exactly one of its cells. only the values which do not collide
+ *  with the filled cells get variables in the clauses, so the filled cells need no clauses of their own.
+ *  if two filled cells collide, an empty clause is added (the formula is unsatisfiable).
+ */
+Sat* buildSat(Board *board)
+{
+	int N, row, column, value, cell, box, i, size;
+	int *group;
+	char *covered;
+	Sat *sat;
+
+	N = board->boardsize;
+	sat = initSat(N*N*N);
+	group = malloc(N*sizeof(int));
+	covered = calloc(3*N*N, sizeof(char));
+	if (!group || !covered)
+	{
+		printf("Error: malloc has failed\n");
+		exit(0);
+	}
+
+	/* two filled cells with the same value in a unit */
+	for (cell=0; cell<N*N && !sat->unsat; cell++)
+	{
+		value = board->values[cell];
+		if (value==0)
+			continue;
+		row = cell/N, column = cell%N, box = BOX(board,row,column);
+		if (covered[row*N+value-1] || covered[N*N+column*N+value-1] || covered[2*N*N+box*N+value-1])
+			addClause(sat, group, 0);
+		covered[row*N+value-1] = covered[N*N+column*N+value-1] = covered[2*N*N+box*N+value-1] = 1;
+	}
+	free(covered);
+
+	/* every empty cell has one value */
+	for (cell=0; cell<N*N; cell++)
+	{
+		if (board->values[cell]!=0)
+			continue;
+		for (value=1, size=0; value<=N; value++)
+			if (isValid(board, cell/N, cell%N, value))
+				group[size++] = 2*(cell*N+value-1);
+		addGroup(sat, group, size);
+	}
+
+	/* every missing value of a row, a column and a box is in one of its empty cells */
+	for (i=0; i<N; i++)
+		for (value=1; value<=N; value++)
+		{
+			if (!(board->rowDigits[i*board->wordsPerUnit+DIGITWORD(value)] & DIGITBIT(value)))
+			{
+				for (column=0, size=0; column<N; column++)
+					if (board->values[CELL(board,i,column)]==0 && isValid(board, i, column, value))
+						group[size++] = 2*(CELL(board,i,column)*N+value-1);
+				addGroup(sat, group, size);
+			}
+			if (!(board->columnDigits[i*board->wordsPerUnit+DIGITWORD(value)] & DIGITBIT(value)))
+			{
+				for (row=0, size=0; row<N; row++)
+					if (board->values[CELL(board,row,i)]==0 && isValid(board, row, i, value))
+						group[size++] = 2*(CELL(board,row,i)*N+value-1);
+				addGroup(sat, group, size);
+			}
+			if (!(board->boxDigits[i*board->wordsPerUnit+DIGITWORD(value)] & DIGITBIT(value)))
+			{
+				/* box i starts at row (i/m)*m and column (i%m)*n */
+				for (cell=0, size=0; cell<N; cell++)
+				{
+					row = (i/board->m)*board->m + cell/board->n;
+					column = (i%board->m)*board->n + cell%board->n;
+					if (board->values[CELL(board,row,column)]==0 && isValid(board, row, column, value))
+						group[size++] = 2*(CELL(board,row,column)*N+value-1);
+				}
+				addGroup(sat, group, size);
+			}
+		}
+	free(group);
+	sat->originalNum = sat->clausesNum;
+	return sat;
+}
+
+/*
+ * initSat
+ *
+ *  This function allocates an empty formula with varsNum variables
+ */
+Sat* initSat(int varsNum)
+{
+	int i;
+	Sat *sat = malloc(sizeof(Sat));
+	if (!sat)
+	{
+		printf("Error: malloc has failed\n");
+		exit(0);
+	}
+	sat->varsNum = varsNum;
+	sat->litsNum = sat->clausesNum = sat->originalNum = 0;
+	sat->litsCapacity = sat->clausesCapacity = 1024;
+	sat->lits = malloc(sat->litsCapacity*sizeof(int));
+	sat->clauseStart = malloc(sat->clausesCapacity*sizeof(int));
+	sat->clauseSize = malloc(sat->clausesCapacity*sizeof(int));
+	sat->unsat = 0;
+	sat->used = calloc(varsNum, sizeof(char));
+	sat->watches = calloc(2*varsNum, sizeof(int*));
+	sat->watchesNum = calloc(2*varsNum, sizeof(int));
+	sat->watchesCapacity = calloc(2*varsNum, sizeof(int));
+	sat->assigns = malloc(varsNum*sizeof(signed char));
+	sat->polarity = calloc(varsNum, sizeof(char));
+	sat->level = malloc(varsNum*sizeof(int));
+	sat->reason = malloc(varsNum*sizeof(int));
+	sat->trail = malloc(varsNum*sizeof(int));
+	sat->trailLimits = malloc((varsNum+1)*sizeof(int));
+	sat->activity = calloc(varsNum, sizeof(double));
+	sat->heap = malloc(varsNum*sizeof(int));
+	sat->heapIndex = malloc(varsNum*sizeof(int));
+	sat->seen = calloc(varsNum, sizeof(char));
+	sat->learnt = malloc(varsNum*sizeof(int));
+	if (!sat->lits || !sat->clauseStart || !sat->clauseSize || !sat->used || !sat->watches || !sat->watchesNum
+			|| !sat->watchesCapacity || !sat->assigns || !sat->polarity || !sat->level || !sat->reason
+			|| !sat->trail || !sat->trailLimits || !sat->activity || !sat->heap || !sat->heapIndex
+			|| !sat->seen || !sat->learnt)
+	{
+		printf("Error: malloc has failed\n");
+		exit(0);
+	}
+	for (i=0; i<varsNum; i++)
+	{
+		sat->assigns[i] = -1;
+		sat->reason[i] = -1;
+		sat->heapIndex[i] = -1;
+	}
+	sat->trailNum = sat->decisionLevel = sat->queueHead = sat->heapNum = 0;
+	sat->varInc = 1;
+	sat->decisions = sat->conflicts = 0;
+	return sat;
+}
+
+/*
+ * destroySat
+ *
+ *  This function frees the formula and the solver's state
+ */
+void destroySat(Sat *sat)
+{
+	int lit;
+	for (lit=0; lit<2*sat->varsNum; lit++)
+		free(sat->watches[lit]);
+	free(sat->watches);
+	free(sat->watchesNum);
+	free(sat->watchesCapacity);
+	free(sat->lits);
+	free(sat->clauseStart);
+	free(sat->clauseSize);
+	free(sat->used);
+	free(sat->assigns);
+	free(sat->polarity);
+	free(sat->level);
+	free(sat->reason);
+	free(sat->trail);
+	free(sat->trailLimits);
+	free(sat->activity);
+	free(sat->heap);
+	free(sat->heapIndex);
+	free(sat->seen);
+	free(sat->learnt);
+	free(sat);
+}
+
+/*
+ * addClause
+ *
+ *  This function adds a clause to the formula (it is not watched yet). an empty clause makes it unsatisfiable.
+ */
+void addClause(Sat *sat, int *lits, int size)
+{
+	int i;
+	if (sat->clausesNum==sat->clausesCapacity)
+	{
+		sat->clausesCapacity *= 2;
+		sat->clauseStart = realloc(sat->clauseStart, sat->clausesCapacity*sizeof(int));
+		sat->clauseSize = realloc(sat->clauseSize, sat->clausesCapacity*sizeof(int));
+	}
+	while (sat->litsNum+size > sat->litsCapacity)
+	{
+		sat->litsCapacity *= 2;
+		sat->lits = realloc(sat->lits, sat->litsCapacity*sizeof(int));
+	}
+	if (!sat->clauseStart || !sat->clauseSize || !sat->lits)
+	{
+		printf("Error: realloc has failed\n");
+		exit(0);
+	}
+	sat->clauseStart[sat->clausesNum] = sat->litsNum;
+	sat->clauseSize[sat->clausesNum] = size;
+	sat->clausesNum++;
+	for (i=0; i<size; i++)
+	{
+		sat->lits[sat->litsNum++] = lits[i];
+		sat->used[VAR(lits[i])] = 1;
+	}
+	if (size==0)
+		sat->unsat = 1;
+}
+
+/*
+ * addGroup
+ *
+ *  This function adds the clauses which say that exactly one of the group's literals is true:
+ *  the group itself, and a clause of two negated literals for every pair
+ */
+void addGroup(Sat *sat, int *group, int size)
+{
+	int i, j, pair[2];
+	addClause(sat, group, size);
+	for (i=0; i<size; i++)
+		for (j=i+1; j<size; j++)
+		{
+			pair[0] = NOT(group[i]);
+			pair[1] = NOT(group[j]);
+			addClause(sat, pair, 2);
+		}
+}
+
+/*
+ * attachClauses
+ *
+ *  This function prepares the search: watches the clauses, assigns the unit clauses on level 0
+ *  and puts the variables in the heap
+ */
+void attachClauses(Sat *sat)
+{
+	int c, var, lit;
+	for (c=0; c<sat->clausesNum && !sat->unsat; c++)
+	{
+		lit = sat->lits[sat->clauseStart[c]];
+		if (sat->clauseSize[c]>=2)
+		{
+			watchClause(sat, lit, c);
+			watchClause(sat, sat->lits[sat->clauseStart[c]+1], c);
+		}
+		else if (litValue(sat, lit)==0)
+			sat->unsat = 1;
+		else if (litValue(sat, lit)==-1)
+			enqueue(sat, lit, -1);
+	}
+	for (var=0; var<sat->varsNum; var++)
+		if (sat->used[var] && sat->assigns[var]==-1)
+			heapInsert(sat, var);
+}
+
+/*
+ * watchClause
+ *
+ *  This function adds a clause to the watch list of a literal
+ */
+void watchClause(Sat *sat, int lit, int clause)
+{
+	if (sat->watchesNum[lit]==sat->watchesCapacity[lit])
+	{
+		sat->watchesCapacity[lit] = sat->watchesCapacity[lit] ? 2*sat->watchesCapacity[lit] : MIN_WATCHES;
+		sat->watches[lit] = realloc(sat->watches[lit], sat->watchesCapacity[lit]*sizeof(int));
+		if (!sat->watches[lit])
+		{
+			printf("Error: realloc has failed\n");
+			exit(0);
+		}
+	}
+	sat->watches[lit][sat->watchesNum[lit]++] = clause;
+}
+
+/*
+ * litValue
+ *
+ *  This function returns the value of a literal: 1 true, 0 false, -1 unassigned
+ */
+int litValue(Sat *sat, int lit)
+{
+	int value = sat->assigns[VAR(lit)];
+	return value==-1 ? -1 : value^(lit&1);
+}
+
+/*
+ * enqueue
+ *
+ *  This function makes a literal true on the current level and adds it to the trail
+ */
+void enqueue(Sat *sat, int lit, int reason)
+{
+	int var = VAR(lit);
+	sat->assigns[var] = (signed char)!(lit&1);
+	sat->level[var] = sat->decisionLevel;
+	sat->reason[var] = reason;
+	sat->trail[sat->trailNum++] = lit;
+}
+
+/*
+ * propagate
+ *
+ *  This function propagates the trail's unpropagated literals. for every clause that watches a literal which
+ *  became false, another non-false literal is looked for to watch instead. if there is none, the other
+ *  watched literal is implied, or the clause is a conflict.
+ *  returns the conflicting clause, or -1 if there is no conflict.
+ */
+int propagate(Sat *sat)
+{
+	int falseLit, *watches, num, i, j, k, c, size, found, *clause;
+	while (sat->queueHead<sat->trailNum)
+	{
+		falseLit = NOT(sat->trail[sat->queueHead++]);
+		watches = sat->watches[falseLit];
+		num = sat->watchesNum[falseLit];
+		for (i=0, j=0; i<num;)
+		{
+			c = watches[i++];
+			clause = sat->lits + sat->clauseStart[c];
+			size = sat->clauseSize[c];
+			/* keep the false literal second */
+			if (clause[0]==falseLit)
+			{
+				clause[0] = clause[1];
+				clause[1] = falseLit;
+			}
+			if (litValue(sat, clause[0])==1) /* the clause is satisfied */
+			{
+				watches[j++] = c;
+				continue;
+			}
+			for (k=2, found=0; k<size && !found; k++)
+				if (litValue(sat, clause[k])!=0)
+				{
+					clause[1] = clause[k];
+					clause[k] = falseLit;
+					watchClause(sat, clause[1], c);
+					found = 1;
+				}
+			if (found)
+				continue;
+			watches[j++] = c;
+			if (litValue(sat, clause[0])==0) /* every literal is false */
+			{
+				while (i<num)
+					watches[j++] = watches[i++];
+				sat->watchesNum[falseLit] = j;
+				sat->queueHead = sat->trailNum;
+				return c;
+			}
+			enqueue(sat, clause[0], c);
+		}
+		sat->watchesNum[falseLit] = j;
+	}
+	return -1;
+}
+
+/*
+ * analyze
+ *
+ *  This function learns a clause from a conflict (first UIP): the conflict's literals are resolved with the
+ *  reasons of the current level's literals, in reverse trail order, until one literal of the current level
+ *  is left. the learnt clause is put in sat->learnt with the asserting literal first and the literal of the
+ *  highest other level second. returns its size, and sets backLevel to the level to go back to.
+ */
+int analyze(Sat *sat, int conflict, int *backLevel)
+{
+	int pathNum=0, lit=-1, size=1, index=sat->trailNum-1, i, j, var, *clause, clauseSize, best;
+	do
+	{
+		clause = sat->lits + sat->clauseStart[conflict];
+		clauseSize = sat->clauseSize[conflict];
+		/* the first literal of a reason is the implied one */
+		for (j=(lit==-1) ? 0 : 1; j<clauseSize; j++)
+		{
+			var = VAR(clause[j]);
+			if (!sat->seen[var] && sat->level[var]>0)
+			{
+				sat->seen[var] = 1;
+				bumpVar(sat, var);
+				if (sat->level[var]>=sat->decisionLevel)
+					pathNum++;
+				else
+					sat->learnt[size++] = clause[j];
+			}
+		}
+		/* the next marked literal on the trail */
+		while (!sat->seen[VAR(sat->trail[index])])
+			index--;
+		lit = sat->trail[index--];
+		conflict = sat->reason[VAR(lit)];
+		sat->seen[VAR(lit)] = 0;
+		pathNum--;
+	} while (pathNum>0);
+	sat->learnt[0] = NOT(lit);
+
+	*backLevel = 0;
+	best = 1;
+	for (i=1; i<size; i++)
+	{
+		sat->seen[VAR(sat->learnt[i])] = 0;
+		if (sat->level[VAR(sat->learnt[i])]>*backLevel)
+		{
+			*backLevel = sat->level[VAR(sat->learnt[i])];
+			best = i;
+		}
+	}
+	if (size>1)
+	{
+		lit = sat->learnt[1];
+		sat->learnt[1] = sat->learnt[best];
+		sat->learnt[best] = lit;
+	}
+	return size;
+}
+
+/*
+ * cancelUntil
+ *
+ *  This function unassigns every literal above the given level, saves their phases and returns
+ *  them to the heap
+ */
+void cancelUntil(Sat *sat, int level)
+{
+	int i, var;
+	if (sat->decisionLevel<=level)
+		return;
+	for (i=sat->trailNum-1; i>=sat->trailLimits[level]; i--)
+	{
+		var = VAR(sat->trail[i]);
+		sat->polarity[var] = (char)sat->assigns[var];
+		sat->assigns[var] = -1;
+		sat->reason[var] = -1;
+		if (sat->heapIndex[var]==-1)
+			heapInsert(sat, var);
+	}
+	sat->trailNum = sat->queueHead = sat->trailLimits[level];
+	sat->decisionLevel = level;
+}
+
+/*
+ * searchSat
+ *
+ *  This function runs the CDCL search: propagate, learn a clause and jump back on every conflict, restart
+ *  by the luby sequence, and otherwise decide on the most active variable.
+ *  returns 1 if every variable got a value without a conflict, 0 if the formula is unsatisfiable.
+ */
+int searchSat(Sat *sat)
+{
+	int conflict, backLevel, size, var, restarts=0;
+	unsigned long restartConflicts=0, restartLimit=RESTART_BASE*luby(0);
+	while (1)
+	{
+		conflict = propagate(sat);
+		if (conflict!=-1)
+		{
+			sat->conflicts++;
+			restartConflicts++;
+			if (sat->decisionLevel==0)
+				return 0;
+			size = analyze(sat, conflict, &backLevel);
+			cancelUntil(sat, backLevel);
+			if (size==1)
+				enqueue(sat, sat->learnt[0], -1);
+			else
+			{
+				addClause(sat, sat->learnt, size);
+				watchClause(sat, sat->learnt[0], sat->clausesNum-1);
+				watchClause(sat, sat->learnt[1], sat->clausesNum-1);
+				enqueue(sat, sat->learnt[0], sat->clausesNum-1);
+			}
+			sat->varInc /= VAR_DECAY;
+			continue;
+		}
+		if (restartConflicts>=restartLimit)
+		{
+			cancelUntil(sat, 0);
+			restartConflicts = 0;
+			restartLimit = RESTART_BASE*luby(++restarts);
+			continue;
+		}
+		/* the most active unassigned variable, with its last value */
+		var = -1;
+		while (sat->heapNum>0 && var==-1)
+		{
+			var = heapPop(sat);
+			if (sat->assigns[var]!=-1)
+				var = -1;
+		}
+		if (var==-1) /* every variable is assigned */
+			return 1;
+		sat->decisions++;
+		sat->trailLimits[sat->decisionLevel++] = sat->trailNum;
+		enqueue(sat, sat->polarity[var] ? 2*var : 2*var+1, -1);
+	}
+}
+
+/*
+ * enumerateSat
+ *
+ *  This function finds the solutions one after another. after a solution, the clause "one of the solution's
+ *  decisions is false" is added - the rest of the solution follows from the decisions - and the search goes
+ *  one level back, where the clause flips the last decision. the learnt clauses stay, since they follow
+ *  from the formula.
+ *  limit - stop after that many solutions (0 = never). onSolution - if not NULL, called for every solution
+ *  while it is written in the board. returns 0 to stop.
+ *  returns the number of found solutions.
+ */
+unsigned long enumerateSat(Board *board, unsigned long limit, int (*onSolution)(Board *board, void *data), void *data)
+{
+	unsigned long count=0;
+	int level, size, stop=0;
+	Sat *sat = buildSat(board);
+
+	attachClauses(sat);
+	while (!sat->unsat && !stop && searchSat(sat))
+	{
+		count++;
+		if (onSolution)
+		{
+			fillSolution(sat, board, 1);
+			stop = !onSolution(board, data);
+			fillSolution(sat, board, 0);
+		}
+		stop = stop || (limit!=0 && count>=limit);
+
+		/* the blocking clause: the decisions imply the rest of the solution. it is asserting after going
+		 * one level back - the last decision flips, and the search goes on from there */
+		for (level=sat->decisionLevel-1, size=0; level>=0; level--)
+			sat->learnt[size++] = NOT(sat->trail[sat->trailLimits[level]]);
+		if (size==0) /* the solution is forced on level 0 - it is the only one */
+			break;
+		cancelUntil(sat, sat->decisionLevel-1);
+		if (size==1)
+			enqueue(sat, sat->learnt[0], -1);
+		else
+		{
+			addClause(sat, sat->learnt, size);
+			watchClause(sat, sat->learnt[0], sat->clausesNum-1);
+			watchClause(sat, sat->learnt[1], sat->clausesNum-1);
+			enqueue(sat, sat->learnt[0], sat->clausesNum-1);
+		}
+	}
+	nodesCount = sat->decisions;
+	destroySat(sat);
+	return count;
+}
+
+/*
+ * fillSolution
+ *
+ *  This function writes the values of the current assignment to the board's empty cells (value=1),
+ *  or empties these cells again (value=0)
+ */
+void fillSolution(Sat *sat, Board *board, int value)
+{
+	int cell, digit, N=board->boardsize;
+	for (cell=0; cell<N*N; cell++)
+		for (digit=1; digit<=N; digit++)
+			if (sat->used[cell*N+digit-1] && sat->assigns[cell*N+digit-1]==1)
+				setCellValue(board, cell/N, cell%N, value ? digit : 0);
+}
+
+/*
+ * bumpVar
+ *
+ *  This function raises the activity of a variable which took part in a conflict
+ */
+void bumpVar(Sat *sat, int var)
+{
+	int i;
+	sat->activity[var] += sat->varInc;
+	if (sat->activity[var]>1e100) /* rescale all the activities */
+	{
+		for (i=0; i<sat->varsNum; i++)
+			sat->activity[i] *= 1e-100;
+		sat->varInc *= 1e-100;
+	}
+	if (sat->heapIndex[var]!=-1)
+		heapUp(sat, sat->heapIndex[var]);
+}
+
+/*
+ * heapUp
+ *
+ *  This function moves the heap's i'th variable up until its parent is at least as active
+ */
+void heapUp(Sat *sat, int i)
+{
+	int var = sat->heap[i], parent;
+	while (i>0)
+	{
+		parent = (i-1)/2;
+		if (sat->activity[sat->heap[parent]]>=sat->activity[var])
+			break;
+		sat->heap[i] = sat->heap[parent];
+		sat->heapIndex[sat->heap[i]] = i;
+		i = parent;
+	}
+	sat->heap[i] = var;
+	sat->heapIndex[var] = i;
+}
+
+/*
+ * heapDown
+ *
+ *  This function moves the heap's i'th variable down until its children are not more active
+ */
+void heapDown(Sat *sat, int i)
+{
+	int var = sat->heap[i], child;
+	while (2*i+1<sat->heapNum)
+	{
+		child = 2*i+1;
+		if (child+1<sat->heapNum && sat->activity[sat->heap[child+1]]>sat->activity[sat->heap[child]])
+			child++;
+		if (sat->activity[sat->heap[child]]<=sat->activity[var])
+			break;
+		sat->heap[i] = sat->heap[child];
+		sat->heapIndex[sat->heap[i]] = i;
+		i = child;
+	}
+	sat->heap[i] = var;
+	sat->heapIndex[var] = i;
+}
+
+/*
+ * heapInsert
+ *
+ *  This function adds a variable to the heap
+ */
+void heapInsert(Sat *sat, int var)
+{
+	sat->heap[sat->heapNum] = var;
+	sat->heapIndex[var] = sat->heapNum;
+	heapUp(sat, sat->heapNum++);
+}
+
+/*
+ * heapPop
+ *
+ *  This function takes the most active variable out of the heap
+ */
+int heapPop(Sat *sat)
+{
+	int var = sat->heap[0];
+	sat->heapIndex[var] = -1;
+	sat->heapNum--;
+	if (sat->heapNum>0)
+	{
+		sat->heap[0] = sat->heap[sat->heapNum];
+		heapDown(sat, 0);
+	}
+	return var;
+}
+
+/*
+ * luby
+ *
+ *  This function returns the x'th element of the luby sequence: 1,1,2,1,1,2,4,1,1,2,1,1,2,4,8...
+ */
+unsigned long luby(int x)
+{
+	int size, seq;
+	unsigned long value=1;
+	for (size=1, seq=0; size<x+1; seq++, size=2*size+1);
+	while (size-1!=x)
+	{
+		size = (size-1)>>1;
+		seq--;
+		x = x%size;
+	}
+	while (seq-->0)
+		value *= 2;
+	return value;
+}
+
+/* End of private methods */
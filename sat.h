@@ -0,0 +1,66 @@
+/*
+ * SAT Module
+ *
+ *  This module solves a sudoku board as a boolean satisfiability problem. The board is encoded in CNF -
+ *  variable cell*N+value is true iff the cell holds the value - and the formula is solved by a
+ *  conflict-driven clause-learning solver (watched literals, first-UIP learning, VSIDS and restarts).
+ *  The CNF can also be written in DIMACS format, for running it with other solvers.
+ */
+
+#ifndef SAT_H_
+#define SAT_H_
+
+#include "game.h"
+
+/*
+ * satSolve
+ *
+ *  This function finds a solution of the board and fills the board's empty cells with it.
+ *  the board is not changed if there is no solution.
+ *  @param board - the board to solve
+ *  @return - 1 if solved, 0 if the board is unsolvable
+ */
+int satSolve(Board *board);
+
+/*
+ * satCount
+ *
+ *  This function counts the solutions of the board: after every solution a clause which blocks it is
+ *  learnt, and the search goes on. the board is not changed.
+ *  @param board - the board
+ *  @param limit - stop counting after that many solutions (0 = count them all)
+ *  @return - number of solutions (at most limit)
+ */
+unsigned long satCount(Board *board, unsigned long limit);
+
+/*
+ * satEnumerate
+ *
+ *  This function goes over all the solutions of the board. for each solution the board's empty cells
+ *  are filled with it and the callback is called. after the callback the cells are emptied again.
+ *  @param board - the board
+ *  @param onSolution - called for every solution, returns 0 in order to stop the enumeration
+ *  @param data - passed to the callback
+ *  @return - number of solutions visited
+ */
+unsigned long satEnumerate(Board *board, int (*onSolution)(Board *board, void *data), void *data);
+
+/*
+ * satWriteDimacs
+ *
+ *  This function writes the CNF of the board to a file in DIMACS format
+ *  @param board - the board
+ *  @param path - the file's path
+ *  @return - 1 if the file was written, 0 if not
+ */
+int satWriteDimacs(Board *board, char *path);
+
+/*
+ * satNodesCount
+ *
+ *  This function returns the number of decisions of the last sat run
+ *  @return - number of decisions
+ */
+unsigned long satNodesCount();
+
+#endif /* SAT_H_ */
@@ -0,0 +1,1222 @@
+/*
+ * Simplex Module
+ *
+ *  This module solves integer linear programs: minimize c*x subject to linear constraints and bounds
+ *  on the variables, where some of the variables must be integers. A presolve fixes the variables which
+ *  the constraints force, the LP relaxation is solved by a bounded revised simplex (two phases) over a
+ *  sparse LU factorization of the basis, and the integer variables are handled by branch and bound.
+ *  The model is built with the functions below, variable after variable and constraint after constraint.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "simplex.h"
+
+#define EPS 1e-9
+#define FEASIBILITY_EPS 1e-6 /* tolerance of the constraints and of integer values */
+#define PIVOT_EPS 1e-7 /* smaller entries of the pivot column are not used as pivots */
+#define DEGENERATE_LIMIT 200 /* degenerate pivots in a row before Bland's rule is used, against cycling */
+#define ITERATIONS_FACTOR 50 /* the simplex gives up after ITERATIONS_FACTOR*(rows+columns) iterations */
+#define REFRESH_PERIOD 100 /* the basis is factorized and the basic values are computed from scratch every that many steps */
+#define PIVOT_THRESHOLD 0.1 /* the LU factorization pivots on entries of at least this part of the column's largest one */
+#define MIN_ENTRIES 256 /* initial capacity of the factorization's entries arrays */
+
+/* The LP struct: the relaxation the simplex works on. its columns are the model's variables which the
+ * presolve has not fixed, a slack for every inequality and an artificial variable for every row (phase 1).
+ * the columns are kept sparse (column j's entries are at colStart[j]..colStart[j+1]-1), and so is the basis:
+ * it is kept as a sparse LU factorization, and the pivots since the factorization as eta columns.
+ * the factorization eliminates the basic columns one after the other: step k eliminates the column of basis
+ * position stepPos[k] with pivot row stepRow[k]. its L column (the multipliers of the rows which are not
+ * pivoted yet) is lRows/lValues[lStart[k]..lStart[k+1]-1], and its U column (the entries of the earlier steps)
+ * is uSteps/uValues[uStart[k]..uStart[k+1]-1] with the pivot uDiag[k]. eta e replaced the column of basis
+ * position etaPos[e], with the entering column's alpha - etaPivot[e] at that position and the other entries at
+ * etaIndex/etaValues[etaStart[e]..etaStart[e+1]-1]. every nonbasic column is at one of its bounds. */
+typedef struct lp {
+	int rowsNum;
+	int colsNum;
+	int structNum; /* the first structNum columns are the model's variables */
+	int artificialStart;
+	int *colStart;
+	int *colRows;
+	double *colValues;
+	int *varOf; /* the model variable of every structural column */
+	double *lower;
+	double *upper;
+	double *cost;
+	double *x;
+	double *rhs;
+	int *basis; /* the basic column of every row */
+	int *basicRow; /* the row of every basic column (-1 for nonbasic ones) */
+	int *stepPos;
+	int *stepRow;
+	int *rowStep; /* the step of every row (-1 while the factorization has not pivoted on it) */
+	int *rowCount; /* the basic entries of every row */
+	int *lStart;
+	int *lRows;
+	double *lValues;
+	int lCapacity;
+	int *uStart;
+	int *uSteps;
+	double *uValues;
+	int uCapacity;
+	double *uDiag;
+	int etaNum;
+	int *etaPos;
+	double *etaPivot;
+	int *etaStart;
+	int *etaIndex;
+	double *etaValues;
+	int etaCapacity;
+	double *y;
+	double *alpha;
+	double *residual;
+	double *work;
+	unsigned long pivots;
+} Lp;
+
+/* The bounds struct: the variables' current bounds during branch and bound. every change is recorded on
+ * a trail (the variable and its bounds before the change), so a branch is undone by going back on the
+ * trail to the length it had when the branch started. the rows of a changed variable are queued for
+ * the presolve. */
+typedef struct bounds {
+	double *lower;
+	double *upper;
+	int *varStart; /* the rows of variable v are varRows[varStart[v]..varStart[v+1]-1] */
+	int *varRows;
+	int *queue; /* circular, every row is in it at most once */
+	char *queued;
+	int head;
+	int tail;
+	int *trailVars;
+	double *trailLower;
+	double *trailUpper;
+	int trailNum;
+	int trailCapacity;
+} Bounds;
+
+/* private methods declaration: */
+Bounds* initBounds(Model *model);
+void destroyBounds(Bounds *bounds);
+void setBounds(Model *model, Bounds *bounds, int var, double lower, double upper);
+void undoBounds(Bounds *bounds, int trailMark);
+int presolve(Model *model, Bounds *bounds);
+Lp* buildLp(Model *model, double *lower, double *upper, double *offset);
+void destroyLp(Lp *lp);
+int solveLp(Lp *lp, Model *model);
+int runSimplex(Lp *lp);
+int factorize(Lp *lp);
+void ftran(Lp *lp, double *vector, double *result);
+void btran(Lp *lp, double *vector, double *result);
+void computeBasics(Lp *lp);
+void computePrices(Lp *lp);
+void pivot(Lp *lp, int row, int column);
+void reserveEntries(int **indices, double **values, int *capacity, int needed);
+int fractionalColumn(Lp *lp, Model *model);
+double lpObjective(Lp *lp, Model *model);
+void* allocate(size_t size);
+
+/* Public methods: */
+
+/*
+ * initModel
+ *
+ *  This function creates a model with varsNum variables, all of them continuous with bounds [0,infinity)
+ *  and no cost, and no constraints
+ *  @param varsNum - number of variables
+ *  @return - pointer to the new model
+ */
+Model* initModel(int varsNum)
+{
+	int i;
+	Model *model = allocate(sizeof(Model));
+	model->varsNum = varsNum;
+	model->lower = allocate((varsNum+1)*sizeof(double));
+	model->upper = allocate((varsNum+1)*sizeof(double));
+	model->cost = allocate((varsNum+1)*sizeof(double));
+	model->integer = allocate((varsNum+1)*sizeof(char));
+	model->solution = allocate((varsNum+1)*sizeof(double));
+	for (i=0; i<varsNum; i++)
+	{
+		model->lower[i] = model->cost[i] = model->solution[i] = 0;
+		model->upper[i] = MODEL_INFINITY;
+		model->integer[i] = 0;
+	}
+	model->rowsNum = 0;
+	model->rowsCapacity = 64;
+	model->nonzerosCapacity = 256;
+	model->rowStart = allocate((model->rowsCapacity+1)*sizeof(int));
+	model->sense = allocate(model->rowsCapacity*sizeof(char));
+	model->rhs = allocate(model->rowsCapacity*sizeof(double));
+	model->rowVars = allocate(model->nonzerosCapacity*sizeof(int));
+	model->rowCoefs = allocate(model->nonzerosCapacity*sizeof(double));
+	model->rowStart[0] = 0;
+	model->objective = 0;
+	model->nodes = model->pivots = 0;
+	return model;
+}
+
+/*
+ * setVarBounds
+ *
+ *  This function sets the bounds of a variable. the lower bound must be finite.
+ *  @param model - the model
+ *  @param var - the variable
+ *  @param lower - lower bound
+ *  @param upper - upper bound (MODEL_INFINITY for none)
+ *  @return -
+ */
+void setVarBounds(Model *model, int var, double lower, double upper)
+{
+	model->lower[var] = lower;
+	model->upper[var] = upper;
+}
+
+/*
+ * setVarCost
+ *
+ *  This function sets the coefficient of a variable in the objective
+ *  @param model - the model
+ *  @param var - the variable
+ *  @param cost - the coefficient
+ *  @return -
+ */
+void setVarCost(Model *model, int var, double cost)
+{
+	model->cost[var] = cost;
+}
+
+/*
+ * setVarInteger
+ *
+ *  This function marks a variable as integer
+ *  @param model - the model
+ *  @param var - the variable
+ *  @return -
+ */
+void setVarInteger(Model *model, int var)
+{
+	model->integer[var] = 1;
+}
+
+/*
+ * addConstraint
+ *
+ *  This function adds the constraint sum(coefs[i]*x[vars[i]]) sense rhs
+ *  @param model - the model
+ *  @param vars - the constraint's variables
+ *  @param coefs - their coefficients
+ *  @param size - number of variables
+ *  @param sense - '=', '<' (at most) or '>' (at least)
+ *  @param rhs - the right hand side
+ *  @return -
+ */
+void addConstraint(Model *model, int *vars, double *coefs, int size, char sense, double rhs)
+{
+	int start = model->rowStart[model->rowsNum];
+	if (model->rowsNum==model->rowsCapacity)
+	{
+		model->rowsCapacity *= 2;
+		model->rowStart = realloc(model->rowStart, (model->rowsCapacity+1)*sizeof(int));
+		model->sense = realloc(model->sense, model->rowsCapacity*sizeof(char));
+		model->rhs = realloc(model->rhs, model->rowsCapacity*sizeof(double));
+	}
+	while (start+size > model->nonzerosCapacity)
+	{
+		model->nonzerosCapacity *= 2;
+		model->rowVars = realloc(model->rowVars, model->nonzerosCapacity*sizeof(int));
+		model->rowCoefs = realloc(model->rowCoefs, model->nonzerosCapacity*sizeof(double));
+	}
+	if (!model->rowStart || !model->sense || !model->rhs || !model->rowVars || !model->rowCoefs)
+	{
+		printf("Error: realloc has failed\n");
+		exit(0);
+	}
+	memcpy(model->rowVars+start, vars, size*sizeof(int));
+	memcpy(model->rowCoefs+start, coefs, size*sizeof(double));
+	model->sense[model->rowsNum] = sense;
+	model->rhs[model->rowsNum] = rhs;
+	model->rowsNum++;
+	model->rowStart[model->rowsNum] = start+size;
+}
+
+/*
+ * solveModel
+ *
+ *  This function minimizes the objective. if a solution is found, it is kept in model->solution. the
+ *  search stops at the first integer solution whose objective is the root relaxation's one (with no
+ *  objective, this is the first integer solution).
+ *  @param model - the model
+ *  @return - MODEL_OPTIMAL, MODEL_INFEASIBLE, MODEL_UNBOUNDED or MODEL_LIMIT
+ */
+int solveModel(Model *model)
+{
+	int i, column, depth=0, capacity=64, status, result=MODEL_INFEASIBLE, feasible, var, done=0;
+	int *branchVar, *branchSide, *branchMark;
+	double *branchValue, offset, objective, best=MODEL_INFINITY, bound=-MODEL_INFINITY;
+	Bounds *bounds;
+	Lp *lp;
+
+	model->nodes = model->pivots = 0;
+	bounds = initBounds(model);
+	/* the branches taken so far: the variable, its value in the parent's relaxation, the side that is
+	 * being tried (1 - rounded up, 2 - rounded down) and the trail's length before the branch */
+	branchVar = allocate(capacity*sizeof(int));
+	branchSide = allocate(capacity*sizeof(int));
+	branchMark = allocate(capacity*sizeof(int));
+	branchValue = allocate(capacity*sizeof(double));
+
+	feasible = presolve(model, bounds);
+	while (1)
+	{
+		/* every node gets its own relaxation, over the variables its presolve has not fixed */
+		lp = feasible ? buildLp(model, bounds->lower, bounds->upper, &offset) : NULL;
+		status = MODEL_INFEASIBLE;
+		var = -1;
+		if (lp)
+		{
+			model->nodes++;
+			status = solveLp(lp, model);
+			model->pivots += lp->pivots;
+		}
+		if (status==MODEL_UNBOUNDED || status==MODEL_LIMIT)
+		{
+			result = status;
+			destroyLp(lp);
+			break;
+		}
+		/* the relaxation of this branch cannot beat the best solution - no need to go deeper */
+		objective = status==MODEL_OPTIMAL ? lpObjective(lp, model) + offset : 0;
+		if (status==MODEL_OPTIMAL && model->nodes==1) /* no solution is better than the root's relaxation */
+			bound = objective;
+		if (status==MODEL_OPTIMAL && objective < best-EPS)
+		{
+			column = fractionalColumn(lp, model);
+			if (column==-1) /* an integer solution */
+			{
+				best = objective;
+				result = MODEL_OPTIMAL;
+				model->objective = objective;
+				for (i=0; i<model->varsNum; i++)
+					model->solution[i] = bounds->lower[i];
+				for (i=0; i<lp->structNum; i++)
+					model->solution[lp->varOf[i]] = lp->x[i];
+				/* it reaches the bound (always, if there is no objective) - the open nodes cannot beat it */
+				done = objective <= bound+EPS;
+			}
+			else /* branch on the column's variable, rounded up first */
+			{
+				if (depth==capacity)
+				{
+					capacity *= 2;
+					branchVar = realloc(branchVar, capacity*sizeof(int));
+					branchSide = realloc(branchSide, capacity*sizeof(int));
+					branchMark = realloc(branchMark, capacity*sizeof(int));
+					branchValue = realloc(branchValue, capacity*sizeof(double));
+					if (!branchVar || !branchSide || !branchMark || !branchValue)
+					{
+						printf("Error: realloc has failed\n");
+						exit(0);
+					}
+				}
+				var = lp->varOf[column];
+				branchVar[depth] = var;
+				branchSide[depth] = 1;
+				branchMark[depth] = bounds->trailNum;
+				branchValue[depth] = lp->x[column];
+				depth++;
+			}
+		}
+		if (lp)
+			destroyLp(lp);
+		if (done)
+			break;
+		if (var!=-1)
+		{
+			setBounds(model, bounds, var, ceil(branchValue[depth-1]), bounds->upper[var]);
+			feasible = presolve(model, bounds);
+			continue;
+		}
+
+		/* go back to the deepest branch whose rounded down side was not tried yet */
+		while (depth>0 && branchSide[depth-1]==2)
+			depth--;
+		if (depth==0)
+			break;
+		undoBounds(bounds, branchMark[depth-1]);
+		branchSide[depth-1] = 2;
+		var = branchVar[depth-1];
+		setBounds(model, bounds, var, bounds->lower[var], floor(branchValue[depth-1]));
+		feasible = presolve(model, bounds);
+	}
+
+	destroyBounds(bounds);
+	free(branchVar);
+	free(branchSide);
+	free(branchMark);
+	free(branchValue);
+	return result;
+}
+
+/*
+ * destroyModel
+ *
+ *  This function frees the model
+ *  @param model - the model
+ *  @return -
+ */
+void destroyModel(Model *model)
+{
+	free(model->lower);
+	free(model->upper);
+	free(model->cost);
+	free(model->integer);
+	free(model->solution);
+	free(model->rowStart);
+	free(model->sense);
+	free(model->rhs);
+	free(model->rowVars);
+	free(model->rowCoefs);
+	free(model);
+}
+
+/* End of public methods */
+
+/* Private methods: */
+
+/*
+ * initBounds
+ *
+ *  This function creates the bounds of the search from the model's bounds (rounded for the integer
+ *  variables), with every row queued and an empty trail
+ */
+Bounds* initBounds(Model *model)
+{
+	int i, row, var, rowsNum=model->rowsNum, varsNum=model->varsNum;
+	Bounds *bounds = allocate(sizeof(Bounds));
+	bounds->lower = allocate((varsNum+1)*sizeof(double));
+	bounds->upper = allocate((varsNum+1)*sizeof(double));
+	for (var=0; var<varsNum; var++)
+	{
+		bounds->lower[var] = model->integer[var] ? ceil(model->lower[var]-FEASIBILITY_EPS) : model->lower[var];
+		bounds->upper[var] = model->integer[var] && model->upper[var]<MODEL_INFINITY ?
+				floor(model->upper[var]+FEASIBILITY_EPS) : model->upper[var];
+	}
+
+	/* the rows of every variable */
+	bounds->varStart = allocate((varsNum+2)*sizeof(int));
+	bounds->varRows = allocate((model->rowStart[rowsNum]+1)*sizeof(int));
+	memset(bounds->varStart, 0, (varsNum+2)*sizeof(int));
+	for (i=0; i<model->rowStart[rowsNum]; i++)
+		bounds->varStart[model->rowVars[i]+2]++;
+	for (var=0; var<varsNum; var++)
+		bounds->varStart[var+2] += bounds->varStart[var+1];
+	for (row=0; row<rowsNum; row++)
+		for (i=model->rowStart[row]; i<model->rowStart[row+1]; i++)
+			bounds->varRows[bounds->varStart[model->rowVars[i]+1]++] = row;
+
+	bounds->queue = allocate((rowsNum+1)*sizeof(int));
+	bounds->queued = allocate((rowsNum+1)*sizeof(char));
+	for (row=0; row<rowsNum; row++)
+	{
+		bounds->queue[row] = row;
+		bounds->queued[row] = 1;
+	}
+	bounds->head = 0;
+	bounds->tail = rowsNum;
+
+	bounds->trailNum = 0;
+	bounds->trailCapacity = 64;
+	bounds->trailVars = allocate(bounds->trailCapacity*sizeof(int));
+	bounds->trailLower = allocate(bounds->trailCapacity*sizeof(double));
+	bounds->trailUpper = allocate(bounds->trailCapacity*sizeof(double));
+	return bounds;
+}
+
+/*
+ * destroyBounds
+ *
+ *  This function frees the bounds of the search
+ */
+void destroyBounds(Bounds *bounds)
+{
+	free(bounds->lower);
+	free(bounds->upper);
+	free(bounds->varStart);
+	free(bounds->varRows);
+	free(bounds->queue);
+	free(bounds->queued);
+	free(bounds->trailVars);
+	free(bounds->trailLower);
+	free(bounds->trailUpper);
+	free(bounds);
+}
+
+/*
+ * setBounds
+ *
+ *  This function changes the bounds of a variable, records the old ones on the trail and queues the
+ *  variable's rows for the presolve
+ */
+void setBounds(Model *model, Bounds *bounds, int var, double lower, double upper)
+{
+	int i, row, size=model->rowsNum+1;
+	if (bounds->trailNum==bounds->trailCapacity)
+	{
+		bounds->trailCapacity *= 2;
+		bounds->trailVars = realloc(bounds->trailVars, bounds->trailCapacity*sizeof(int));
+		bounds->trailLower = realloc(bounds->trailLower, bounds->trailCapacity*sizeof(double));
+		bounds->trailUpper = realloc(bounds->trailUpper, bounds->trailCapacity*sizeof(double));
+		if (!bounds->trailVars || !bounds->trailLower || !bounds->trailUpper)
+		{
+			printf("Error: realloc has failed\n");
+			exit(0);
+		}
+	}
+	bounds->trailVars[bounds->trailNum] = var;
+	bounds->trailLower[bounds->trailNum] = bounds->lower[var];
+	bounds->trailUpper[bounds->trailNum] = bounds->upper[var];
+	bounds->trailNum++;
+	bounds->lower[var] = lower;
+	bounds->upper[var] = upper;
+	for (i=bounds->varStart[var]; i<bounds->varStart[var+1]; i++)
+	{
+		row = bounds->varRows[i];
+		if (!bounds->queued[row])
+		{
+			bounds->queued[row] = 1;
+			bounds->queue[bounds->tail++ % size] = row;
+		}
+	}
+}
+
+/*
+ * undoBounds
+ *
+ *  This function restores the bounds by going back on the trail to the given length
+ */
+void undoBounds(Bounds *bounds, int trailMark)
+{
+	int var;
+	while (bounds->trailNum>trailMark)
+	{
+		bounds->trailNum--;
+		var = bounds->trailVars[bounds->trailNum];
+		bounds->lower[var] = bounds->trailLower[bounds->trailNum];
+		bounds->upper[var] = bounds->trailUpper[bounds->trailNum];
+	}
+}
+
+/*
+ * presolve
+ *
+ *  This function tightens the bounds: a row whose smallest possible activity equals its right hand side
+ *  forces every variable to the bound which gives that activity, and the same for the largest activity.
+ *  the queued rows are checked, and the rows of every fixed variable are queued again, until the queue is
+ *  empty. (in the sudoku formulation this fixes the given cells' peers and propagates naked and hidden
+ *  singles.) returns 0 if some row cannot be satisfied - the queue is emptied anyway.
+ */
+int presolve(Model *model, Bounds *bounds)
+{
+	int row, i, var, feasible=1, low, high, size=model->rowsNum+1;
+	char sense;
+	double minActivity, maxActivity, coef, *lower=bounds->lower, *upper=bounds->upper;
+
+	while (bounds->tail-bounds->head>0)
+	{
+		row = bounds->queue[bounds->head++ % size];
+		bounds->queued[row] = 0;
+		if (!feasible)
+			continue;
+		sense = model->sense[row];
+		minActivity = maxActivity = 0;
+		low = high = 1; /* whether the activities are finite */
+		for (i=model->rowStart[row]; i<model->rowStart[row+1]; i++)
+		{
+			var = model->rowVars[i];
+			coef = model->rowCoefs[i];
+			if (lower[var]>upper[var]+FEASIBILITY_EPS)
+				feasible = 0;
+			if (coef>0)
+			{
+				minActivity += coef*lower[var];
+				if (upper[var]<MODEL_INFINITY)
+					maxActivity += coef*upper[var];
+				else
+					high = 0;
+			}
+			else
+			{
+				maxActivity += coef*lower[var];
+				if (upper[var]<MODEL_INFINITY)
+					minActivity += coef*upper[var];
+				else
+					low = 0;
+			}
+		}
+		if ((sense!='>' && low && minActivity > model->rhs[row]+FEASIBILITY_EPS)
+				|| (sense!='<' && high && maxActivity < model->rhs[row]-FEASIBILITY_EPS))
+			feasible = 0;
+		/* the activity is forced to one of its ends */
+		high = high && sense!='<' && maxActivity <= model->rhs[row]+FEASIBILITY_EPS;
+		low = low && !high && sense!='>' && minActivity >= model->rhs[row]-FEASIBILITY_EPS;
+		if (!feasible || (!low && !high))
+			continue;
+		for (i=model->rowStart[row]; i<model->rowStart[row+1]; i++)
+		{
+			var = model->rowVars[i];
+			if (upper[var]-lower[var]<EPS)
+				continue;
+			if ((model->rowCoefs[i]>0) == (low!=0))
+				setBounds(model, bounds, var, lower[var], lower[var]);
+			else
+				setBounds(model, bounds, var, upper[var], upper[var]);
+		}
+	}
+	bounds->head = bounds->tail = 0;
+	return feasible;
+}
+
+/*
+ * buildLp
+ *
+ *  This function builds the relaxation over the variables which are not fixed. the fixed variables move to
+ *  the right hand side, and their cost to offset. rows without free variables are left out.
+ *  returns NULL if such a row is violated.
+ */
+Lp* buildLp(Model *model, double *lower, double *upper, double *offset)
+{
+	int *colOf, *counts, row, i, var, rowsNum=0, structNum=0, slacksNum=0, nonzeros=0, freeNum, column, next;
+	double rhs;
+	Lp *lp = allocate(sizeof(Lp));
+
+	/* the columns of the free variables */
+	colOf = allocate((model->varsNum+1)*sizeof(int));
+	*offset = 0;
+	for (var=0; var<model->varsNum; var++)
+	{
+		colOf[var] = upper[var]-lower[var]<EPS ? -1 : structNum++;
+		if (colOf[var]==-1)
+			*offset += model->cost[var]*lower[var];
+	}
+	/* the rows that are left */
+	counts = allocate((structNum+1)*sizeof(int));
+	memset(counts, 0, (structNum+1)*sizeof(int));
+	for (row=0; row<model->rowsNum; row++)
+	{
+		freeNum = 0;
+		rhs = model->rhs[row];
+		for (i=model->rowStart[row]; i<model->rowStart[row+1]; i++)
+		{
+			if (colOf[model->rowVars[i]]==-1)
+				rhs -= model->rowCoefs[i]*lower[model->rowVars[i]];
+			else
+				freeNum++;
+		}
+		if (freeNum==0)
+		{
+			if ((model->sense[row]!='>' && rhs < -FEASIBILITY_EPS) || (model->sense[row]!='<' && rhs > FEASIBILITY_EPS))
+			{
+				free(colOf);
+				free(counts);
+				free(lp);
+				return NULL;
+			}
+			continue;
+		}
+		for (i=model->rowStart[row]; i<model->rowStart[row+1]; i++)
+			if (colOf[model->rowVars[i]]!=-1)
+				counts[colOf[model->rowVars[i]]]++;
+		nonzeros += freeNum;
+		slacksNum += model->sense[row]!='=';
+		rowsNum++;
+	}
+
+	lp->rowsNum = rowsNum;
+	lp->structNum = structNum;
+	lp->artificialStart = structNum+slacksNum;
+	lp->colsNum = structNum+slacksNum+rowsNum;
+	lp->colStart = allocate((lp->colsNum+1)*sizeof(int));
+	lp->colRows = allocate((nonzeros+slacksNum+rowsNum+1)*sizeof(int));
+	lp->colValues = allocate((nonzeros+slacksNum+rowsNum+1)*sizeof(double));
+	lp->varOf = allocate((structNum+1)*sizeof(int));
+	lp->lower = allocate((lp->colsNum+1)*sizeof(double));
+	lp->upper = allocate((lp->colsNum+1)*sizeof(double));
+	lp->cost = allocate((lp->colsNum+1)*sizeof(double));
+	lp->x = allocate((lp->colsNum+1)*sizeof(double));
+	lp->basicRow = allocate((lp->colsNum+1)*sizeof(int));
+	lp->rhs = allocate((rowsNum+1)*sizeof(double));
+	lp->basis = allocate((rowsNum+1)*sizeof(int));
+	lp->y = allocate((rowsNum+1)*sizeof(double));
+	lp->alpha = allocate((rowsNum+1)*sizeof(double));
+	lp->residual = allocate((rowsNum+1)*sizeof(double));
+	lp->work = allocate((rowsNum+1)*sizeof(double));
+	lp->stepPos = allocate((rowsNum+1)*sizeof(int));
+	lp->stepRow = allocate((rowsNum+1)*sizeof(int));
+	lp->rowStep = allocate((rowsNum+1)*sizeof(int));
+	lp->rowCount = allocate((rowsNum+1)*sizeof(int));
+	lp->lStart = allocate((rowsNum+1)*sizeof(int));
+	lp->uStart = allocate((rowsNum+1)*sizeof(int));
+	lp->uDiag = allocate((rowsNum+1)*sizeof(double));
+	lp->lCapacity = lp->uCapacity = lp->etaCapacity = MIN_ENTRIES;
+	lp->lRows = allocate(lp->lCapacity*sizeof(int));
+	lp->lValues = allocate(lp->lCapacity*sizeof(double));
+	lp->uSteps = allocate(lp->uCapacity*sizeof(int));
+	lp->uValues = allocate(lp->uCapacity*sizeof(double));
+	lp->etaIndex = allocate(lp->etaCapacity*sizeof(int));
+	lp->etaValues = allocate(lp->etaCapacity*sizeof(double));
+	lp->etaPos = allocate((REFRESH_PERIOD+1)*sizeof(int));
+	lp->etaPivot = allocate((REFRESH_PERIOD+1)*sizeof(double));
+	lp->etaStart = allocate((REFRESH_PERIOD+2)*sizeof(int));
+	lp->etaNum = 0;
+	lp->pivots = 0;
+
+	/* the structural columns first, then the slacks and the artificial variables (one entry each) */
+	lp->colStart[0] = 0;
+	for (column=0; column<structNum; column++)
+		lp->colStart[column+1] = lp->colStart[column]+counts[column];
+	for (column=structNum; column<lp->colsNum; column++)
+		lp->colStart[column+1] = lp->colStart[column]+1;
+	for (var=0; var<model->varsNum; var++)
+		if (colOf[var]!=-1)
+		{
+			column = colOf[var];
+			lp->varOf[column] = var;
+			lp->lower[column] = lower[var];
+			lp->upper[column] = upper[var];
+			counts[column] = lp->colStart[column]; /* the next free entry of the column */
+		}
+
+	rowsNum = 0;
+	next = structNum;
+	for (row=0; row<model->rowsNum; row++)
+	{
+		freeNum = 0;
+		rhs = model->rhs[row];
+		for (i=model->rowStart[row]; i<model->rowStart[row+1]; i++)
+		{
+			if (colOf[model->rowVars[i]]==-1)
+				rhs -= model->rowCoefs[i]*lower[model->rowVars[i]];
+			else
+				freeNum++;
+		}
+		if (freeNum==0)
+			continue;
+		for (i=model->rowStart[row]; i<model->rowStart[row+1]; i++)
+		{
+			column = colOf[model->rowVars[i]];
+			if (column==-1)
+				continue;
+			lp->colRows[counts[column]] = rowsNum;
+			lp->colValues[counts[column]++] = model->rowCoefs[i];
+		}
+		if (model->sense[row]!='=')
+		{
+			lp->colRows[lp->colStart[next]] = rowsNum;
+			lp->colValues[lp->colStart[next]] = model->sense[row]=='<' ? 1 : -1;
+			lp->lower[next] = 0;
+			lp->upper[next] = MODEL_INFINITY;
+			next++;
+		}
+		lp->colRows[lp->colStart[lp->artificialStart+rowsNum]] = rowsNum;
+		lp->rhs[rowsNum] = rhs;
+		rowsNum++;
+	}
+	free(colOf);
+	free(counts);
+	return lp;
+}
+
+/*
+ * destroyLp
+ *
+ *  This function frees the relaxation
+ */
+void destroyLp(Lp *lp)
+{
+	free(lp->colStart);
+	free(lp->colRows);
+	free(lp->colValues);
+	free(lp->varOf);
+	free(lp->lower);
+	free(lp->upper);
+	free(lp->cost);
+	free(lp->x);
+	free(lp->basicRow);
+	free(lp->rhs);
+	free(lp->basis);
+	free(lp->y);
+	free(lp->alpha);
+	free(lp->residual);
+	free(lp->work);
+	free(lp->stepPos);
+	free(lp->stepRow);
+	free(lp->rowStep);
+	free(lp->rowCount);
+	free(lp->lStart);
+	free(lp->uStart);
+	free(lp->uDiag);
+	free(lp->lRows);
+	free(lp->lValues);
+	free(lp->uSteps);
+	free(lp->uValues);
+	free(lp->etaIndex);
+	free(lp->etaValues);
+	free(lp->etaPos);
+	free(lp->etaPivot);
+	free(lp->etaStart);
+	free(lp);
+}
+
+/*
+ * solveLp
+ *
+ *  This function solves the relaxation with the current bounds from scratch. phase 1 starts from the
+ *  basis of the artificial variables and minimizes their sum. phase 2 bounds them to 0 and minimizes
+ *  the model's objective.
+ *  returns MODEL_OPTIMAL, MODEL_INFEASIBLE, MODEL_UNBOUNDED or MODEL_LIMIT.
+ */
+int solveLp(Lp *lp, Model *model)
+{
+	int i, j, k, m=lp->rowsNum, status;
+	double sum;
+
+	for (j=0; j<lp->artificialStart; j++)
+	{
+		if (lp->lower[j]>lp->upper[j]+FEASIBILITY_EPS)
+			return MODEL_INFEASIBLE;
+		lp->x[j] = lp->lower[j];
+		lp->basicRow[j] = -1;
+		lp->cost[j] = 0;
+	}
+	/* every artificial variable takes what its row misses, with the sign that keeps it positive */
+	for (i=0; i<m; i++)
+		lp->residual[i] = lp->rhs[i];
+	for (j=0; j<lp->artificialStart; j++)
+		for (k=lp->colStart[j]; k<lp->colStart[j+1]; k++)
+			lp->residual[lp->colRows[k]] -= lp->colValues[k]*lp->x[j];
+	for (i=0; i<m; i++)
+	{
+		j = lp->artificialStart+i;
+		lp->colValues[lp->colStart[j]] = lp->residual[i]>=0 ? 1 : -1;
+		lp->lower[j] = 0;
+		lp->upper[j] = MODEL_INFINITY;
+		lp->cost[j] = 1;
+		lp->basis[i] = j;
+		lp->basicRow[j] = i;
+	}
+
+	status = runSimplex(lp);
+	if (status!=MODEL_OPTIMAL)
+		return status==MODEL_UNBOUNDED ? MODEL_INFEASIBLE : status; /* phase 1 is never unbounded */
+	for (i=0, sum=0; i<m; i++)
+		sum += lp->x[lp->artificialStart+i];
+	if (sum>FEASIBILITY_EPS)
+		return MODEL_INFEASIBLE;
+
+	for (j=lp->artificialStart; j<lp->colsNum; j++)
+	{
+		lp->upper[j] = 0;
+		lp->cost[j] = 0;
+		if (lp->basicRow[j]==-1)
+			lp->x[j] = 0;
+	}
+	for (j=0; j<lp->structNum; j++)
+		lp->cost[j] = model->cost[lp->varOf[j]];
+	return runSimplex(lp);
+}
+
+/*
+ * runSimplex
+ *
+ *  This function runs the bounded simplex from the current basis. the entering column is the one with the
+ *  best reduced cost (Dantzig), or the first improving one after many degenerate pivots (Bland). a column
+ *  whose own bound is reached before any basic variable's bound just moves to its other bound.
+ *  the basic values are updated on every step, and the basis is factorized and the basic values are computed
+ *  again every REFRESH_PERIOD steps against rounding errors. the prices are computed on every step.
+ *  returns MODEL_LIMIT if the iterations limit was reached or the basis is (numerically) singular.
+ */
+int runSimplex(Lp *lp)
+{
+	int i, j, k, m=lp->rowsNum, entering, leaving, direction=1, degenerate=0, bland;
+	unsigned long iterations=0, limit=(unsigned long)ITERATIONS_FACTOR*(m+lp->colsNum);
+	double reduced, best, theta, t, a;
+
+	while (1)
+	{
+		if (iterations%REFRESH_PERIOD==0)
+		{
+			if (!factorize(lp))
+				return MODEL_LIMIT;
+			computeBasics(lp);
+		}
+		if (iterations++ > limit)
+			return MODEL_LIMIT;
+		computePrices(lp);
+		bland = degenerate>DEGENERATE_LIMIT;
+
+		/* the entering column */
+		entering = -1;
+		best = EPS;
+		for (j=0; j<lp->colsNum && !(bland && entering!=-1); j++)
+		{
+			if (lp->basicRow[j]!=-1 || lp->upper[j]-lp->lower[j]<EPS)
+				continue;
+			reduced = lp->cost[j];
+			for (k=lp->colStart[j]; k<lp->colStart[j+1]; k++)
+				reduced -= lp->y[lp->colRows[k]]*lp->colValues[k];
+			if (lp->x[j]<=lp->lower[j] && -reduced>best)
+				entering = j, best = -reduced, direction = 1;
+			else if (lp->x[j]>=lp->upper[j] && reduced>best)
+				entering = j, best = reduced, direction = -1;
+		}
+		if (entering==-1)
+			return MODEL_OPTIMAL;
+
+		/* alpha = B^-1 * A[entering] */
+		for (i=0; i<m; i++)
+			lp->work[i] = 0;
+		for (k=lp->colStart[entering]; k<lp->colStart[entering+1]; k++)
+			lp->work[lp->colRows[k]] = lp->colValues[k];
+		ftran(lp, lp->work, lp->alpha);
+
+		/* the ratio test: the basic variables move by -direction*theta*alpha */
+		theta = lp->upper[entering]-lp->lower[entering];
+		leaving = -1;
+		for (i=0; i<m; i++)
+		{
+			a = direction*lp->alpha[i];
+			if (a>PIVOT_EPS)
+				t = (lp->x[lp->basis[i]]-lp->lower[lp->basis[i]])/a;
+			else if (a<-PIVOT_EPS && lp->upper[lp->basis[i]]<MODEL_INFINITY)
+				t = (lp->upper[lp->basis[i]]-lp->x[lp->basis[i]])/(-a);
+			else
+				continue;
+			if (t<0)
+				t = 0;
+			if (t<theta-EPS || (bland && t<=theta+EPS && leaving!=-1 && lp->basis[i]<lp->basis[leaving]))
+				theta = t, leaving = i;
+		}
+		if (theta>=MODEL_INFINITY)
+			return MODEL_UNBOUNDED;
+		degenerate = theta<EPS ? degenerate+1 : 0;
+
+		/* move along the direction */
+		for (i=0; i<m; i++)
+			lp->x[lp->basis[i]] -= direction*theta*lp->alpha[i];
+		if (leaving==-1) /* the entering column just moves to its other bound */
+		{
+			lp->x[entering] = direction==1 ? lp->upper[entering] : lp->lower[entering];
+			continue;
+		}
+		j = lp->basis[leaving];
+		lp->x[entering] += direction*theta;
+		lp->x[j] = direction*lp->alpha[leaving]>0 ? lp->lower[j] : lp->upper[j];
+		pivot(lp, leaving, entering);
+	}
+}
+
+/*
+ * factorize
+ *
+ *  This function computes the LU factorization of the basis, and drops the eta columns. the columns are
+ *  eliminated from the sparsest one, and every step pivots on the row with the fewest basic entries among
+ *  the large enough entries of the column (threshold pivoting), so the factors stay sparse.
+ *  returns 0 if the basis is singular.
+ */
+int factorize(Lp *lp)
+{
+	int i, j, k, e, m=lp->rowsNum, column, row, pos, size, lNum=0, uNum=0, *counts=lp->lStart;
+	double *w=lp->work, largest, value;
+
+	/* the basic entries of every row, and the steps' positions ordered by their columns' sizes (a counting
+	 * sort, which counts in lStart before the L columns are there) */
+	for (i=0; i<=m; i++)
+		counts[i] = 0;
+	for (i=0; i<m; i++)
+		lp->rowCount[i] = 0;
+	for (pos=0; pos<m; pos++)
+	{
+		column = lp->basis[pos];
+		size = lp->colStart[column+1]-lp->colStart[column];
+		counts[size<m ? size : m]++;
+		for (k=lp->colStart[column]; k<lp->colStart[column+1]; k++)
+			lp->rowCount[lp->colRows[k]]++;
+	}
+	for (i=1; i<=m; i++)
+		counts[i] += counts[i-1];
+	for (pos=m-1; pos>=0; pos--)
+	{
+		column = lp->basis[pos];
+		size = lp->colStart[column+1]-lp->colStart[column];
+		lp->stepPos[--counts[size<m ? size : m]] = pos;
+	}
+	for (i=0; i<m; i++)
+	{
+		lp->rowStep[i] = -1;
+		w[i] = 0;
+	}
+	lp->lStart[0] = lp->uStart[0] = 0;
+	for (k=0; k<m; k++)
+	{
+		pos = lp->stepPos[k];
+		column = lp->basis[pos];
+		for (e=lp->colStart[column]; e<lp->colStart[column+1]; e++)
+			w[lp->colRows[e]] = lp->colValues[e];
+		/* the eliminations of the earlier steps */
+		for (j=0; j<k; j++)
+		{
+			value = w[lp->stepRow[j]];
+			if (value!=0)
+				for (e=lp->lStart[j]; e<lp->lStart[j+1]; e++)
+					w[lp->lRows[e]] -= lp->lValues[e]*value;
+		}
+		/* the U column: the entries at the rows of the earlier steps */
+		reserveEntries(&lp->uSteps, &lp->uValues, &lp->uCapacity, uNum+k);
+		for (j=0; j<k; j++)
+		{
+			row = lp->stepRow[j];
+			if (fabs(w[row])>EPS)
+			{
+				lp->uSteps[uNum] = j;
+				lp->uValues[uNum++] = w[row];
+			}
+			w[row] = 0;
+		}
+		/* the pivot row among the rows which are not pivoted yet */
+		largest = 0;
+		for (i=0; i<m; i++)
+			if (lp->rowStep[i]==-1 && fabs(w[i])>largest)
+				largest = fabs(w[i]);
+		if (largest<PIVOT_EPS)
+			return 0;
+		row = -1;
+		for (i=0; i<m; i++)
+			if (lp->rowStep[i]==-1 && fabs(w[i])>=PIVOT_THRESHOLD*largest
+					&& (row==-1 || lp->rowCount[i]<lp->rowCount[row]))
+				row = i;
+		lp->uDiag[k] = w[row];
+		lp->rowStep[row] = k;
+		/* the L column: the multipliers of the other rows */
+		reserveEntries(&lp->lRows, &lp->lValues, &lp->lCapacity, lNum+m);
+		for (i=0; i<m; i++)
+		{
+			if (w[i]!=0 && i!=row && fabs(w[i])>EPS)
+			{
+				lp->lRows[lNum] = i;
+				lp->lValues[lNum++] = w[i]/lp->uDiag[k];
+			}
+			w[i] = 0;
+		}
+		lp->stepRow[k] = row;
+		lp->lStart[k+1] = lNum;
+		lp->uStart[k+1] = uNum;
+	}
+	lp->etaNum = 0;
+	lp->etaStart[0] = 0;
+	return 1;
+}
+
+/*
+ * ftran
+ *
+ *  This function solves B*result = vector: the L eliminations and the U substitution, and then the eta
+ *  columns in the order of their pivots. vector is indexed by the rows (and is used as work space), result
+ *  by the basis positions.
+ */
+void ftran(Lp *lp, double *vector, double *result)
+{
+	int k, e, m=lp->rowsNum;
+	double value;
+	for (k=0; k<m; k++)
+	{
+		value = vector[lp->stepRow[k]];
+		if (value!=0)
+			for (e=lp->lStart[k]; e<lp->lStart[k+1]; e++)
+				vector[lp->lRows[e]] -= lp->lValues[e]*value;
+	}
+	for (k=m-1; k>=0; k--)
+	{
+		value = vector[lp->stepRow[k]]/lp->uDiag[k];
+		vector[lp->stepRow[k]] = 0;
+		result[lp->stepPos[k]] = value;
+		if (value!=0)
+			for (e=lp->uStart[k]; e<lp->uStart[k+1]; e++)
+				vector[lp->stepRow[lp->uSteps[e]]] -= lp->uValues[e]*value;
+	}
+	for (k=0; k<lp->etaNum; k++)
+	{
+		value = result[lp->etaPos[k]]/lp->etaPivot[k];
+		result[lp->etaPos[k]] = value;
+		if (value!=0)
+			for (e=lp->etaStart[k]; e<lp->etaStart[k+1]; e++)
+				result[lp->etaIndex[e]] -= lp->etaValues[e]*value;
+	}
+}
+
+/*
+ * btran
+ *
+ *  This function solves result*B = vector: the eta columns from the last one, and then the U substitution
+ *  and the L eliminations transposed. vector is indexed by the basis positions (and is used as work space),
+ *  result by the rows.
+ */
+void btran(Lp *lp, double *vector, double *result)
+{
+	int k, e, m=lp->rowsNum;
+	double value;
+	for (k=lp->etaNum-1; k>=0; k--)
+	{
+		value = vector[lp->etaPos[k]];
+		for (e=lp->etaStart[k]; e<lp->etaStart[k+1]; e++)
+			value -= lp->etaValues[e]*vector[lp->etaIndex[e]];
+		vector[lp->etaPos[k]] = value/lp->etaPivot[k];
+	}
+	for (k=0; k<m; k++)
+	{
+		value = vector[lp->stepPos[k]];
+		for (e=lp->uStart[k]; e<lp->uStart[k+1]; e++)
+			value -= lp->uValues[e]*result[lp->stepRow[lp->uSteps[e]]];
+		result[lp->stepRow[k]] = value/lp->uDiag[k];
+	}
+	for (k=m-1; k>=0; k--)
+	{
+		value = result[lp->stepRow[k]];
+		for (e=lp->lStart[k]; e<lp->lStart[k+1]; e++)
+			value -= lp->lValues[e]*result[lp->lRows[e]];
+		result[lp->stepRow[k]] = value;
+	}
+}
+
+/*
+ * computeBasics
+ *
+ *  This function computes the basic variables from the nonbasic ones: xB = B^-1 * (b - N*xN)
+ */
+void computeBasics(Lp *lp)
+{
+	int i, j, k, m=lp->rowsNum;
+	for (i=0; i<m; i++)
+		lp->residual[i] = lp->rhs[i];
+	for (j=0; j<lp->colsNum; j++)
+		if (lp->basicRow[j]==-1 && lp->x[j]!=0)
+			for (k=lp->colStart[j]; k<lp->colStart[j+1]; k++)
+				lp->residual[lp->colRows[k]] -= lp->colValues[k]*lp->x[j];
+	ftran(lp, lp->residual, lp->work);
+	for (i=0; i<m; i++)
+		lp->x[lp->basis[i]] = lp->work[i];
+}
+
+/*
+ * computePrices
+ *
+ *  This function computes the prices y = cB * B^-1
+ */
+void computePrices(Lp *lp)
+{
+	int i, m=lp->rowsNum;
+	for (i=0; i<m; i++)
+		lp->work[i] = lp->cost[lp->basis[i]];
+	btran(lp, lp->work, lp->y);
+}
+
+/*
+ * pivot
+ *
+ *  This function replaces the basic column of a row by another column, and adds the eta column of
+ *  lp->alpha (the new column in terms of the old basis) to the factorization
+ */
+void pivot(Lp *lp, int row, int column)
+{
+	int i, m=lp->rowsNum, etaNum=lp->etaNum, next=lp->etaStart[etaNum];
+	reserveEntries(&lp->etaIndex, &lp->etaValues, &lp->etaCapacity, next+m);
+	for (i=0; i<m; i++)
+		if (i!=row && fabs(lp->alpha[i])>EPS)
+		{
+			lp->etaIndex[next] = i;
+			lp->etaValues[next++] = lp->alpha[i];
+		}
+	lp->etaPos[etaNum] = row;
+	lp->etaPivot[etaNum] = lp->alpha[row];
+	lp->etaStart[etaNum+1] = next;
+	lp->etaNum++;
+	lp->basicRow[lp->basis[row]] = -1;
+	lp->basis[row] = column;
+	lp->basicRow[column] = row;
+	lp->pivots++;
+}
+
+/*
+ * fractionalColumn
+ *
+ *  This function returns the integer column whose value is the most fractional (-1 if they are all integers)
+ */
+int fractionalColumn(Lp *lp, Model *model)
+{
+	int j, column=-1;
+	double fraction, best=FEASIBILITY_EPS;
+	for (j=0; j<lp->structNum; j++)
+	{
+		if (!model->integer[lp->varOf[j]])
+			continue;
+		fraction = lp->x[j]-floor(lp->x[j]);
+		if (fraction>0.5)
+			fraction = 1-fraction;
+		if (fraction>best)
+			best = fraction, column = j;
+	}
+	return column;
+}
+
+/*
+ * lpObjective
+ *
+ *  This function returns the objective of the relaxation's current solution (without the fixed variables)
+ */
+double lpObjective(Lp *lp, Model *model)
+{
+	int j;
+	double objective=0;
+	for (j=0; j<lp->structNum; j++)
+		objective += model->cost[lp->varOf[j]]*lp->x[j];
+	return objective;
+}
+
+/*
+ * reserveEntries
+ *
+ *  This function makes room for at least needed entries in a pair of index and value arrays
+ */
+void reserveEntries(int **indices, double **values, int *capacity, int needed)
+{
+	if (needed<=*capacity)
+		return;
+	while (*capacity<needed)
+		*capacity *= 2;
+	*indices = realloc(*indices, *capacity*sizeof(int));
+	*values = realloc(*values, *capacity*sizeof(double));
+	if (!*indices || !*values)
+	{
+		printf("Error: realloc has failed\n");
+		exit(0);
+	}
+}
+
+/*
+ * allocate
+ *
+ *  This function allocates memory and exits if it cannot
+ */
+void* allocate(size_t size)
+{
+	void *memory = malloc(size);
+	if (!memory)
+	{
+		printf("Error: malloc has failed\n");
+		exit(0);
+	}
+	return memory;
+}
+
+/* End of private methods */
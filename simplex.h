@@ -0,0 +1,120 @@
+/*
+ * Simplex Module
+ *
+ *  This module solves integer linear programs: minimize c*x subject to linear constraints and bounds
+ *  on the variables, where some of the variables must be integers. A presolve fixes the variables which
+ *  the constraints force, the LP relaxation is solved by a bounded revised simplex (two phases) over a
+ *  sparse LU factorization of the basis, and the integer variables are handled by branch and bound.
+ *  The model is built with the functions below, variable after variable and constraint after constraint.
+ */
+
+#ifndef SIMPLEX_H_
+#define SIMPLEX_H_
+
+#define MODEL_INFINITY 1e30 /* an unbounded variable bound */
+
+#define MODEL_INFEASIBLE 0 /* the results of solveModel */
+#define MODEL_OPTIMAL 1
+#define MODEL_UNBOUNDED 2
+#define MODEL_LIMIT 3 /* the simplex gave up: its iterations limit was reached or its basis got singular */
+
+/* The model struct: the variables' bounds and costs, and the constraints kept row after row -
+ * the variables and coefficients of row i are at rowStart[i]..rowStart[i+1]-1 */
+typedef struct model {
+	int varsNum;
+	double *lower;
+	double *upper;
+	double *cost;
+	char *integer;
+	int rowsNum;
+	int rowsCapacity;
+	int *rowStart;
+	int *rowVars;
+	double *rowCoefs;
+	int nonzerosCapacity;
+	char *sense; /* '=', '<' (at most) or '>' (at least) */
+	double *rhs;
+	double *solution; /* the variables' values after solveModel found a solution */
+	double objective;
+	unsigned long nodes; /* branch and bound nodes of the last solve */
+	unsigned long pivots; /* simplex pivots of the last solve */
+} Model;
+
+/*
+ * initModel
+ *
+ *  This function creates a model with varsNum variables, all of them continuous with bounds [0,infinity)
+ *  and no cost, and no constraints
+ *  @param varsNum - number of variables
+ *  @return - pointer to the new model
+ */
+Model* initModel(int varsNum);
+
+/*
+ * setVarBounds
+ *
+ *  This function sets the bounds of a variable. the lower bound must be finite.
+ *  @param model - the model
+ *  @param var - the variable
+ *  @param lower - lower bound
+ *  @param upper - upper bound (MODEL_INFINITY for none)
+ *  @return -
+ */
+void setVarBounds(Model *model, int var, double lower, double upper);
+
+/*
+ * setVarCost
+ *
+ *  This function sets the coefficient of a variable in the objective
+ *  @param model - the model
+ *  @param var - the variable
+ *  @param cost - the coefficient
+ *  @return -
+ */
+void setVarCost(Model *model, int var, double cost);
+
+/*
+ * setVarInteger
+ *
+ *  This function marks a variable as integer
+ *  @param model - the model
+ *  @param var - the variable
+ *  @return -
+ */
+void setVarInteger(Model *model, int var);
+
+/*
+ * addConstraint
+ *
+ *  This function adds the constraint sum(coefs[i]*x[vars[i]]) sense rhs
+ *  @param model - the model
+ *  @param vars - the constraint's variables
+ *  @param coefs - their coefficients
+ *  @param size - number of variables
+ *  @param sense - '=', '<' (at most) or '>' (at least)
+ *  @param rhs - the right hand side
+ *  @return -
+ */
+void addConstraint(Model *model, int *vars, double *coefs, int size, char sense, double rhs);
+
+/*
+ * solveModel
+ *
+ *  This function minimizes the objective. if a solution is found, it is kept in model->solution. the
+ *  search stops at the first integer solution whose objective is the root relaxation's one (with no
+ *  objective, this is the first integer solution).
+ *  @param model - the model
+ *  @return - MODEL_OPTIMAL, MODEL_INFEASIBLE, MODEL_UNBOUNDED or MODEL_LIMIT
+ */
+int solveModel(Model *model);
+
+/*
+ * destroyModel
+ *
+ *  This function frees the model
+ *  @param model - the model
+ *  @return -
+ */
+void destroyModel(Model *model);
+
+#endif /* SIMPLEX_H_ */
@@ -10,15 +10,59 @@
 #include <string.h>
 #include <time.h>
 #include "game.h"
+#include "solver.h"
 #include "stack.h"
 #include "mainAux.h"
 #include "ILPSolver.h"
+#include "backtrack.h"
+#include "dlx.h"
+#include "sat.h"
+#include "propagate.h"
+#include "alldiff.h"
+#include "classic.h"
+#include "kernels.h"
+#include "arena.h"
 
 #define GENERATE_ITERS 1000 /* maximum size of iterations in the generate function */
 
+/* An engine which can solve boards. count and enumerate may be NULL - the backtracking ones are
+ * used instead. nodesCount returns the search nodes of the engine's last run, and skippedCount (if not
+ * NULL) the nodes it skipped. */
+typedef struct engine {
+	char *name;
+	int (*solve)(Board *board);
+	unsigned long (*count)(Board *board, unsigned long limit);
+	unsigned long (*enumerate)(Board *board, int (*onSolution)(Board *board, void *data), void *data);
+	unsigned long (*nodesCount)();
+	unsigned long (*skippedCount)();
+} Engine;
+
+/* the engines registry - the first one is the default. the ilp engine is much slower than the search
+ * engines on boards above 9x9, so it runs only when it is selected */
+static Engine engines[] = {
+	{"dlx", dlxSolve, dlxCount, dlxEnumerate, dlxNodesCount, NULL},
+	{"ilp", ilpSolve, NULL, NULL, ilpNodesCount, NULL},
+	{"backtrack", backtrackSolve, backtrackCount, backtrackEnumerate, backtrackNodesCount, backtrackSkippedCount},
+	{"sat", satSolve, satCount, satEnumerate, satNodesCount, NULL}
+};
+
+/* the backtracking engine (engines[2]), which counts and enumerates for the engines that cannot */
+static Engine *fallbackEngine = engines+2;
+
+/* the dedicated 9x9 engine, which is used for classic boards as long as no engine was selected */
+static Engine classicEngine = {"classic", classicSolve, classicCount, NULL, classicNodesCount, NULL};
+
+static Engine *currentEngine = engines; /* the engine that solves and counts boards */
+static int engineSelected = 0; /* an engine was selected by the user, so it is used for all the boards */
+static Engine *lastEngine = engines; /* the engine of the last solve or count */
+static unsigned long lastSearchNodes = 0; /* search nodes of the last solve or count */
+static unsigned long lastSkippedNodes = 0; /* nodes the last solve or count skipped */
+
 /* private methods declaration: */
 void markErrors(Board *board, int row, int column);
-int findFirstCell(Board* board, int* x, int* y);
+int* allocateFilled(Board* board);
+Engine* boardEngine(Board* board);
+int prepareBoard(Board* board, Engine* engine, int* filled, int* filledNum);
 
 /* Public methods: */
 
@@ -34,48 +78,23 @@ int findFirstCell(Board* board, int* x, int* y);
  */
 int isValid(Board *board, int row, int column, int value)
 {
-    int i,j;
-    int n,m,boardsize;
-    int modifiedRow, modifiedColumn;
-
-    /* dimensions definition: */
-	n=board->n;
-	m=board->m;
-	boardsize=board->boardsize;
-
-	modifiedRow = (row/m)*m;
-	modifiedColumn = (column/n)*n;
-    for (i=0;i<boardsize; i++)
-    {
-    	/* check if it is valid value in the row t=and the column */
-    	if (board->cells[row][i].value==value || board->cells[i][column].value==value)
-            return 0;
-    }
-
-    /* check if it is valid value in the box */
-    for (i=0;i<m; i++)
-        for (j=0;j<n; j++)
-        {
-        	if (board->cells[modifiedRow+i][modifiedColumn+j].value==value)
-                return 0;
-        }
-
-    return 1;
+	/* the value is valid iff it is not used in the row, the column and the box */
+	return board->kernels->isValid(board, row, column, value);
 }
 
 /*
  * validate
  *
- *  This function gets the actual user board, makes a copy of it and then runs ILP on the copy
- *  in order if the board is solvable.
+ *  This function gets the actual user board, solves it in place and then gives it back as it was (by a
+ *  snapshot, so the board is not copied) in order to check if the board is solvable.
  *  @param board - the actual game board (not a copy of it)
  *  @return - 1 if solveable, 0 if not.
  */
 int validate(Board* board){
-	Board* boardCopy = copyBoard(board);
-	int result = ilpSolve(boardCopy);
-	/* the copyboard function allocates some memory, hence we have to free this memory */
-	destroyBoard(boardCopy);
+	Snapshot* snapshot = takeSnapshot(board);
+	int result = solveBoard(board);
+	/* empty the cells the solution has filled */
+	restoreSnapshot(snapshot);
 	return result;
 }
 
@@ -95,9 +114,7 @@ int validate(Board* board){
 int generate(Board* userBoard, List *undoList, int x, int y){
 	/* assuming the board is empty, we are in edit mode, and x,y are valid integers */
 	int i,j,l,N,randRow,randCol, chosenValue;
-	int pickedXCells=1, isBoardSolvable=1, filledSuccessfully = 0, randIndex=0, changesCount=0;
-	int** moves;
-	Node* newNode = NULL;
+	int pickedXCells=1, isBoardSolvable=1, filledSuccessfully = 0, randIndex=0;
 
 	N=userBoard->boardsize; /* n*m */
 
@@ -112,19 +129,19 @@ int generate(Board* userBoard, List *undoList, int x, int y){
 			/* randomly choose x cells */
 			randRow = rand()%N;
 			randCol = rand()%N;
-			if(userBoard->cells[randRow][randCol].value!=0){
+			if(userBoard->values[CELL(userBoard,randRow,randCol)]!=0){
 				j--;
 				continue;
 			}
 			/* randomly choose legal values for each cell */
 			setOptions(userBoard,randRow,randCol);
-			if(userBoard->cells[randRow][randCol].numOfOptions==0){
+			if(userBoard->numOfOptions[CELL(userBoard,randRow,randCol)]==0){
 				pickedXCells = 0;
 				break;
 			}
-			randIndex = rand()%userBoard->cells[randRow][randCol].numOfOptions;
-			chosenValue = userBoard->cells[randRow][randCol].options[randIndex];
-			userBoard->cells[randRow][randCol].value = chosenValue;
+			randIndex = rand()%userBoard->numOfOptions[CELL(userBoard,randRow,randCol)];
+			chosenValue = userBoard->options[CELL(userBoard,randRow,randCol)*N + randIndex];
+			setCellValue(userBoard,randRow,randCol,chosenValue);
 		}
 
 		/* if we didn't succeed in choosing x cells, try again */
@@ -134,7 +151,7 @@ int generate(Board* userBoard, List *undoList, int x, int y){
 			continue;
 		}
 		/* move on to the next part if and only if the new temp board is solvable */
-		isBoardSolvable = ilpSolve(userBoard);
+		isBoardSolvable = solveBoard(userBoard);
 		if(!isBoardSolvable){
 			resetBoard(userBoard);
 			isBoardSolvable=1;
@@ -152,31 +169,21 @@ int generate(Board* userBoard, List *undoList, int x, int y){
 	for(l=1;l<=(N*N - y);l++){
 		randRow = rand()%N;
 		randCol = rand()%N;
-		if(userBoard->cells[randRow][randCol].value==0){
+		if(userBoard->values[CELL(userBoard,randRow,randCol)]==0){
 			l--;
 			continue;
 		}
-		userBoard->cells[randRow][randCol].value = 0;
+		setCellValue(userBoard,randRow,randCol,0);
 	}
 
-	/* we have to remember to move that we need since we have to update the undo list */
-	moves = malloc(y*sizeof(int*));
-	if(!moves){
-		printf("Error: malloc has failed\n");
-		exit(0);
-		return 0;
-	}
+	/* we have to remember to move that we need since we have to update the undo list - one turn */
 	for(i=0;i<N;i++){
 		for(j=0;j<N;j++){
-			if(userBoard->cells[i][j].value!=0){
-				insertSingleMove(moves, changesCount, i, j, 0, userBoard->cells[i][j].value);
-				changesCount++;
-			}
+			if(userBoard->values[CELL(userBoard,i,j)]!=0)
+				recordMove(undoList, CELL(userBoard,i,j), 0, userBoard->values[CELL(userBoard,i,j)]);
 		}
 	}
-	/*node preparation for the undo list */
-	updateMovesInNode(&newNode,moves, y);
-	addMove(undoList,newNode);
+	endTurn(undoList);
 
 	return 1;
 }
@@ -186,7 +193,7 @@ int generate(Board* userBoard, List *undoList, int x, int y){
  *
  *  This function gets the gameboard and the undoList, go over each cell and checks if there's only 1 valid value
  *  for it. if yes - sets it (by push it to the stack and go over the stack after), print the action and insert it
- *  to the undoList (again - by go over the stack)
+ *  to the undoList (again - by go over the stack). the singles of a 9x9 board are found by the classic engine.
  *
  *  @param board - the actual game board
  *  @param undoList - pointer to the undo list
@@ -196,74 +203,49 @@ void autoFill(Board *board,List *undoList)
 {
 	int i,j;
 	int N;
-	int optionalValue,movesNum,prevValue;
-	int theOption = 0;
-	int** moves;
+	int prevValue;
+	int theOption;
+	int *singles=NULL;
 	Stack* stack;
-	StackNode* poppedNode;
-	Node* newNode = NULL;
+	StackNode* node;
 
 	/* dimensions definition: */
 	N=board->boardsize;
 
-	/*stack*/
-	stack = initStack();
-	poppedNode = (StackNode*)malloc(sizeof(StackNode));
-	if(!poppedNode){
-			printf("Error: malloc has failed\n");
-			exit(0);
-		}
+	/*stack - a temporary of the command, in the arena*/
+	stack = initArenaStack(N*N);
+
+	if(isClassic(board)){
+		singles = arenaAlloc(N*N*sizeof(int));
+		classicSingles(board, singles);
+	}
 
 	/* check for each cell if there's only 1 valid value for it */
 	for (i=0;i<N; i++){
 		for (j=0; j<N; j++){
-			if(board->cells[i][j].value!=0)
+			if(board->values[CELL(board,i,j)]!=0)
 				continue;
-			for (optionalValue = 1; optionalValue <= N; optionalValue++)
-				if (isValid(board, i, j, optionalValue)){
-					if (theOption == 0){
-						theOption = optionalValue;
-					}
-					else{
-						theOption = 0;
-						break;
-					}
-				}
+			theOption = singles ? singles[CELL(board,i,j)] : singleValue(board, i, j);
 
 			/*if there's only 1 valid value for the cell, push it to the stack and print the set*/
 			if (theOption != 0){
 				push(stack,i,j,theOption);
 				printf("Cell <%d,%d> set to %d\n",j+1,i+1,theOption);
-				theOption = 0;
 			}
 		}
 	}
 
-	movesNum=stack->length;
-	moves = malloc(movesNum*sizeof(int*));
-	if(!moves){
-			printf("Error: malloc has failed\n");
-			exit(0);
-		}
-	/* go over the stack and set the values for the cells */
-	while(!isEmpty(stack)){
-		pop(stack,poppedNode);
-		prevValue = board->cells[poppedNode->column][poppedNode->row].value;
-		board->cells[poppedNode->column][poppedNode->row].value = poppedNode->value;
-		markErrors(board,poppedNode->column,poppedNode->row);
-		insertSingleMove(moves, stack->length, poppedNode->column, poppedNode->row, prevValue, poppedNode->value);
-	}
-	/* update the list iff the autofill actually did something */
-	if(movesNum != 0)
-	{
-		/*node preparation*/
-		updateMovesInNode(&newNode,moves, movesNum);
-		addMove(undoList,newNode);
+	/* go over the stack (from its bottom, so the turn's moves are in the board's order) and set the values
+	 * for the cells */
+	for (i=0; i<stack->length; i++){
+		node = &stack->nodes[i];
+		prevValue = board->values[CELL(board,node->column,node->row)];
+		setCellValue(board,node->column,node->row,node->value);
+		markErrors(board,node->column,node->row);
+		recordMove(undoList, CELL(board,node->column,node->row), prevValue, node->value);
 	}
-	else{
-		free(moves);
-	}
-	free(poppedNode);
+	/* the log gets a turn iff the autofill actually did something */
+	endTurn(undoList);
 	destroyStack(stack);
 }
 
@@ -271,91 +253,217 @@ void autoFill(Board *board,List *undoList)
  * getNumSolutions
  *
  *  This function gets a game board, and returns the number of the valid solutions for this
- *  board. this time we use an iterative solution to solve the problem. we use stack to demonstrate
- *  the recursive calls. we push and pop from the stack depends on the iterations until we count
- *  all the possible solutions
+ *  board, counted by the selected engine (by the classic engine for a 9x9 board, if no engine was
+ *  selected). engines which cannot count check first that the board is solvable, and leave the
+ *  counting to the backtracking (the stats are of the engine which counted). the counting stops one solution past the limit, so "is there
+ *  exactly one solution" is answered with limit 1.
  *
  *  @param board - the actual game board
- *  @return - number of possible solutions
+ *  @param limit - the most solutions to report (0 = count them all)
+ *  @param overflow - set to 1 if the board has more than limit solutions, 0 otherwise
+ *  @return - number of possible solutions (at most limit)
  */
-int getNumSolutions(Board* board)
+unsigned long getNumSolutions(Board* board, unsigned long limit, int* overflow)
 {
-	int i=0,j=0,size,foundVal,count;
-	StackNode* poppedNode;
-	Stack* stack;
-	size=board->boardsize;
-	count=0,foundVal=0;
-
-	if(!validate(board)) /* in case of a non-valid board, we can quit now and return 0*/
-		return 0;
-
-	stack=initStack();
-	/* memory allocated for the nodes that are about to be popped */
-	poppedNode = malloc(sizeof(StackNode));
-	if (poppedNode == NULL) {
-		exit(0);
+	unsigned long count=0, stopAt;
+	size_t mark=arenaMark();
+	int filledNum, solvable, *filled=allocateFilled(board);
+	Snapshot *snapshot;
+	Engine *engine=boardEngine(board);
+
+	/* one solution more than the limit tells a board which has exactly limit solutions from a bigger one
+	 * (limit+1 wraps to 0 - no limit - for the biggest limit, which cannot be passed anyway) */
+	stopAt = limit!=0 ? limit+1 : 0;
+	lastSearchNodes = lastSkippedNodes = 0;
+	lastEngine = engine;
+	/* the singles are in every solution, so filling them first does not change the count */
+	if(prepareBoard(board, engine, filled, &filledNum))
+	{
+		if(engine->count)
+		{
+			count = engine->count(board, stopAt);
+			lastSearchNodes = engine->nodesCount();
+			lastSkippedNodes = engine->skippedCount ? engine->skippedCount() : 0;
+		}
+		else
+		{
+			/* the engine only tells whether the board is solvable (on a snapshot, so its solution is not
+			 * left in the board) - in case of an unsolvable board, we can skip the counting */
+			snapshot = takeSnapshot(board);
+			solvable = engine->solve(board);
+			restoreSnapshot(snapshot);
+			lastSearchNodes = engine->nodesCount();
+			if(solvable)
+			{
+				count = fallbackEngine->count(board, stopAt);
+				lastEngine = fallbackEngine;
+				lastSearchNodes = fallbackEngine->nodesCount();
+				lastSkippedNodes = fallbackEngine->skippedCount();
+			}
+		}
 	}
+	undoSingles(board, filled, filledNum);
+	arenaRewind(mark);
+	*overflow = limit!=0 && count>limit;
+	return *overflow ? limit : count;
+}
 
-	/* find the first cell to deal with */
-	foundVal = findFirstCell(board, &i, &j);
-	/* in case the board is full and valid */
-	if(!foundVal)
-		return 1;
-	push(stack,i,j,1); /* try the first possible value  */
-	/* if the stack is not empty, it means that there are still some cases to simulate  */
-	while(!isEmpty(stack)){
-		foundVal = 0;
-		/* if the current assignment is legal, move on to the next empty cell  */
-		if(isValid(board,top(stack)->column,top(stack)->row,top(stack)->value)){
-			board->cells[top(stack)->column][top(stack)->row].value = top(stack)->value;
-			/* find the first cell to deal with */
-			foundVal = findFirstCell(board, &i, &j);
-			/* if we find another empty cell after the assignment, we go one step further in
-			 * our simulated recursion, (push new node the to stack  */
-			if(foundVal){
-				push(stack,i,j,1);
-			}
-			else{ /* if we got here, it means that we solved the board*/
-				/* increase the counter */
-				count = count + 1;
-				/* zero the last filled cell */
-				board->cells[top(stack)->column][top(stack)->row].value = 0;
-				if(top(stack)->value<size){
-					stack->currentNode->value = stack->currentNode->value + 1;
-				}
-				else{
-					/* if this is not a valid solution, go back to a previously filled cell */
-					while(!isEmpty(stack) && top(stack)->value == size){
-						pop(stack,poppedNode);
-						if(!isEmpty(stack))
-							board->cells[top(stack)->column][top(stack)->row].value = 0;
-					}
-					/* if stack is not empty, try another possible value for the last filled cell */
-					if(!isEmpty(stack))
-						top(stack)->value = top(stack)->value + 1;
-				}
-			}
+/*
+ * enumerateSolutions
+ *
+ *  This function goes over the solutions of the board with the selected engine (with the backtracking, if the
+ *  engine cannot enumerate, as for a 9x9 board when no engine was selected). for each solution
+ *  the board's empty cells are filled with it and the callback is called, then emptied again.
+ *
+ *  @param board - the board (usually a copy of the game board)
+ *  @param onSolution - called for every solution, returns 0 in order to stop the enumeration
+ *  @param data - passed to the callback
+ *  @return - number of solutions visited
+ */
+unsigned long enumerateSolutions(Board* board, int (*onSolution)(Board *board, void *data), void *data)
+{
+	unsigned long count=0;
+	size_t mark=arenaMark();
+	int filledNum, *filled=allocateFilled(board);
+	Engine *engine=boardEngine(board);
+
+	lastSearchNodes = lastSkippedNodes = 0;
+	lastEngine = engine;
+	if(prepareBoard(board, engine, filled, &filledNum))
+	{
+		if(engine->enumerate)
+		{
+			count = engine->enumerate(board, onSolution, data);
+			lastSearchNodes = engine->nodesCount();
+			lastSkippedNodes = engine->skippedCount ? engine->skippedCount() : 0;
 		}
-		else{ /* if the current assignment is illegal, try another assignment of value  */
-			if(top(stack)->value<size){
-				top(stack)->value = top(stack)->value + 1;
-			}
-			else{/* if we tried all the options for assignment, go back to to
-					a previously filled cell*/
-				while(!isEmpty(stack) && top(stack)->value == size){
-					pop(stack,poppedNode);
-					if(stack->length>0)
-						board->cells[top(stack)->column][top(stack)->row].value = 0;
-				}
-				if(!isEmpty(stack))
-					top(stack)->value = top(stack)->value + 1;
-			}
+		else
+		{
+			count = fallbackEngine->enumerate(board, onSolution, data);
+			lastEngine = fallbackEngine;
+			lastSearchNodes = fallbackEngine->nodesCount();
+			lastSkippedNodes = fallbackEngine->skippedCount();
 		}
 	}
-	/*free all memory resources that were used in function*/
-	free(poppedNode);
-	destroyStack(stack);
-	return count; /* return the number of possible solutions */
+	undoSingles(board, filled, filledNum);
+	arenaRewind(mark);
+	return count;
+}
+
+/*
+ * solveBoard
+ *
+ *  This function solves the board with the selected engine (with the classic engine for a 9x9 board, if
+ *  no engine was selected) and fills the board with the solution. the naked and hidden singles are filled
+ *  first, so the engine gets a smaller board, and boards which the all-different matching finds
+ *  unsolvable are not searched at all.
+ *
+ *  @param board - the board to solve (usually a copy of the game board)
+ *  @return - 1 if solved, 0 if the board is unsolvable
+ */
+int solveBoard(Board* board)
+{
+	size_t mark=arenaMark();
+	int result=0, filledNum, *filled=allocateFilled(board);
+	Engine *engine=boardEngine(board);
+
+	lastSearchNodes = lastSkippedNodes = 0;
+	lastEngine = engine;
+	if(prepareBoard(board, engine, filled, &filledNum))
+	{
+		result = engine->solve(board);
+		lastSearchNodes = engine->nodesCount();
+		lastSkippedNodes = engine->skippedCount ? engine->skippedCount() : 0;
+	}
+	if(!result) /* the board is given back unchanged */
+		undoSingles(board, filled, filledNum);
+	arenaRewind(mark);
+	return result;
+}
+
+/*
+ * selectSolver
+ *
+ *  This function selects the engine which is used for validate, hint, generate and num_solutions.
+ *
+ *  @param name - the engine's name (see getEngineName)
+ *  @return - 1 if the engine was selected, 0 if there is no such engine
+ */
+int selectSolver(char* name)
+{
+	int i;
+	for(i=0; getEngineName(i)!=NULL; i++)
+		if(strcmp(name,engines[i].name)==0)
+		{
+			currentEngine = &engines[i];
+			engineSelected = 1;
+			return 1;
+		}
+	return 0;
+}
+
+/*
+ * getSolverName
+ *
+ *  This function returns the name of the selected engine
+ *
+ *  @return - the engine's name
+ */
+char* getSolverName()
+{
+	return currentEngine->name;
+}
+
+/*
+ * getEngineName
+ *
+ *  This function returns the name of an engine in the registry
+ *
+ *  @param index - the engine's index
+ *  @return - the engine's name, NULL if there are less engines
+ */
+char* getEngineName(int index)
+{
+	if(index<0 || index>=(int)(sizeof(engines)/sizeof(engines[0])))
+		return NULL;
+	return engines[index].name;
+}
+
+/*
+ * getLastSolverName
+ *
+ *  This function returns the name of the engine which ran the last solve or count
+ *
+ *  @return - the engine's name
+ */
+char* getLastSolverName()
+{
+	return lastEngine->name;
+}
+
+/*
+ * getSearchNodes
+ *
+ *  This function returns the number of search nodes the last solve or count has visited
+ *
+ *  @return - number of nodes
+ */
+unsigned long getSearchNodes()
+{
+	return lastSearchNodes;
+}
+
+/*
+ * getSkippedNodes
+ *
+ *  This function returns the number of search nodes the last solve or count has skipped, by backjumping
+ *  and by nogoods (0 for the engines which do not skip nodes)
+ *
+ *  @return - number of skipped nodes
+ */
+unsigned long getSkippedNodes()
+{
+	return lastSkippedNodes;
 }
 
 /*
@@ -372,70 +480,8 @@ int getNumSolutions(Board* board)
  */
 void markErrors(Board *board, int row, int column)
 {
-    int i,j;
-    int n,m,boardsize;
-    int modifiedRow, modifiedColumn;
-    int value;
-
-    /* dimensions definition: */
-	n=board->n;
-	m=board->m;
-	boardsize=board->boardsize;
-
-	/*gets the upper left cell of the block - the "first" cell*/
-	modifiedRow = (row/m)*m;
-	modifiedColumn = (column/n)*n;
-    for (i=0;i<boardsize; i++)
-    {
-    	/*goes over the column - mark and unmark errors if needed*/
-    	value = board->cells[row][i].value;
-    	if(value !=0)
-    	{
-    		board->cells[row][i].value = 0; /*change the specific chcecked cell's value to 0 - that's how isValid works*/
-        	if (isValid(board, row, i, value)) /*check if the value is valid*/
-    			board->cells[row][i].error = 0; /*it is - error = 0*/
-        	else
-        		board->cells[row][i].error = 1; /*it's not - error = 1*/
-
-        	board->cells[row][i].value = value; /*change it back to the original value*/
-    	}
-    	else
-    		board->cells[row][i].error = 0; /*the value is 0 there for cannot be an error*/
-
-    	/*goes over the row - mark and unmark errors if needed*/
-    	value = board->cells[i][column].value;
-    	if(value !=0)
-    	{
-    		board->cells[i][column].value = 0;
-        	if (isValid(board, i, column, value))
-    			board->cells[i][column].error = 0;
-        	else
-        		board->cells[i][column].error = 1;
-
-        	board->cells[i][column].value = value;
-    	}
-    	else
-    		board->cells[i][column].error = 0;
-    }
-
-    /*goes over the block - mark and unmark errors if needed*/
-    for (i=0;i<m; i++)
-        for (j=0;j<n; j++)
-        {
-        	value = board->cells[modifiedRow+i][modifiedColumn+j].value;
-        	if(value !=0)
-        	{
-        		board->cells[modifiedRow+i][modifiedColumn+j].value = 0;
-        		if (isValid(board,modifiedRow+i,modifiedColumn+j, value))
-        			board->cells[modifiedRow+i][modifiedColumn+j].error = 0;
-            	else
-            		board->cells[modifiedRow+i][modifiedColumn+j].error = 1;
-
-        		board->cells[modifiedRow+i][modifiedColumn+j].value = value;
-        	}
-        	else
-        		board->cells[modifiedRow+i][modifiedColumn+j].error = 0;
-        }
+	/* the kernel of the board's geometry goes over the row, the column and the block */
+	board->kernels->markErrors(board, row, column);
 }
 
 
@@ -449,15 +495,7 @@ void markErrors(Board *board, int row, int column)
  *  @return - 1 if there's at least 1 error in the board, 0 otherwise
  */
 int isThereAnError(Board *board){
-	int i,j, size;
-	size=board->boardsize;
-
-	for (i=0;i<size; i++)
-		for (j=0; j<size; j++)
-			if(board->cells[i][j].error == 1)
-				return 1;
-
-	return 0;
+	return board->errorsNum > 0;
 }
 
 /*
@@ -469,11 +507,10 @@ int isThereAnError(Board *board){
  *  @return -
  */
 void markAllBoardErrors(Board* board){
-    int row,column;
-    int boardsize;
-    int value;
+	int row,column,error;
+	int boardsize;
 
-    /* dimensions definition: */
+	/* dimensions definition: */
 	boardsize=board->boardsize;
 
 	/*goes over all the cells in the board*/
@@ -481,24 +518,59 @@ void markAllBoardErrors(Board* board){
 		for(column=0;column<boardsize;column++)
 		{
 			/* only unfixed cells can be erroneous */
-			if(!board->cells[row][column].fixed)
+			if(!board->fixed[CELL(board,row,column)])
 			{
-				value = board->cells[row][column].value;
-				board->cells[row][column].value = 0; /*again - sets the value to 0 in order that isValid will work*/
-				if (value!=0) /*only cells with values can be erroneous*/
-				{
-					/*check if it is valid and update the error sign oppositely*/
-					board->cells[row][column].error = !isValid(board,row,column,value);
-					/*
-					if(board->cells[row][column].error==1)
-						board->cells[row][column].fixed = 0;
-					*/
-				}
-
-				board->cells[row][column].value = value; /*change it back to the original value*/
+				error = board->kernels->isErroneous(board,row,column);
+				board->errorsNum += error - board->error[CELL(board,row,column)];
+				board->error[CELL(board,row,column)] = (char)error;
 			}
+		}
+}
 
+/*
+ * markMovesErrors
+ *
+ *  This function is called after the moves of a turn were applied (undo or redo of a turn) - it updates the
+ *  error flags once for all the rows, columns and blocks the moves have changed, instead of marking the
+ *  errors around every move.
+ *
+ *  @param board - the actual game board
+ *  @param moves - the turn's moves
+ *  @param movesNum - number of moves
+ *  @return -
+ */
+void markMovesErrors(Board* board, Move* moves, int movesNum)
+{
+	int i, unit, cell, error, boardsize=board->boardsize;
+	int *cellUnits, *unitCells;
+	char *changed;
+	size_t mark;
+
+	if(movesNum==1){
+		markErrors(board, moves[0].cell/boardsize, moves[0].cell%boardsize);
+		return;
+	}
+	/* the units (the rows, then the columns, then the blocks) which hold a changed cell */
+	mark = arenaMark();
+	changed = arenaAlloc(3*boardsize);
+	memset(changed, 0, 3*boardsize);
+	for(i=0;i<movesNum;i++){
+		cellUnits = board->geometry->cellUnits + 3*moves[i].cell;
+		changed[cellUnits[0]] = changed[boardsize+cellUnits[1]] = changed[2*boardsize+cellUnits[2]] = 1;
+	}
+	/* every cell of a changed unit gets its flag again */
+	for(unit=0;unit<3*boardsize;unit++){
+		if(!changed[unit])
+			continue;
+		unitCells = board->geometry->unitCells + unit*boardsize;
+		for(i=0;i<boardsize;i++){
+			cell = unitCells[i];
+			error = board->kernels->isErroneous(board, cell/boardsize, cell%boardsize);
+			board->errorsNum += error - board->error[cell];
+			board->error[cell] = (char)error;
 		}
+	}
+	arenaRewind(mark);
 }
 
 /* End of public methods */
@@ -506,29 +578,43 @@ void markAllBoardErrors(Board* board){
 /* Private methods: */
 
 /*
- * findFirstCell
+ * allocateFilled
  *
- *  This function finds the first empty cell for the num_solution algorithm to deal with
- *  it stores the x,y coordinate of the cell in the x,y parameters, and returns whether or not
- *  this kind of cell actually exists.
+ *  This function allocates the array of cells which propagateSingles fills (one entry for every cell), in the
+ *  command's arena
  */
-int findFirstCell(Board* board, int* x, int* y)
+int* allocateFilled(Board* board)
 {
-	int i=0, j=0, size = board->boardsize, foundVal=0;
-	/* find the first cell to deal with */
-	for(i=0;i<size;i++){
-		for(j=0;j<size;j++)
-			if(board->cells[i][j].fixed==0 && board->cells[i][j].value==0)
-			{
-				foundVal=1;
-				*x = i;
-				*y = j;
-				break;
-			}
-		if(foundVal)
-			break;
-	}
-	return foundVal;
+	return arenaAlloc(board->boardsize*board->boardsize*sizeof(int));
+}
+
+/*
+ * boardEngine
+ *
+ *  This function returns the engine which solves and counts a board: the selected one, or the classic
+ *  engine for a 9x9 board if the user did not select any engine
+ */
+Engine* boardEngine(Board* board)
+{
+	if(!engineSelected && isClassic(board))
+		return &classicEngine;
+	return currentEngine;
+}
+
+/*
+ * prepareBoard
+ *
+ *  This function fills the board's singles before an engine runs, and checks the board with the
+ *  all-different matching (the classic engine fills the singles by itself, so nothing is done for it).
+ *  returns 0 if the board was found unsolvable, 1 otherwise.
+ */
+int prepareBoard(Board* board, Engine* engine, int* filled, int* filledNum)
+{
+	*filledNum = 0;
+	if(engine==&classicEngine)
+		return 1;
+	/* the matching filter proves most unsolvable boards without any search */
+	return propagateSingles(board, filled, filledNum) && allDifferentFilter(board, NULL);
 }
 
 /* End of private methods */
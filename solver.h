@@ -65,14 +65,100 @@ void autoFill(Board *board,List *undoList);
  * getNumSolutions
  *
  *  This function gets a game board, and returns the number of the valid solutions for this
- *  board. this time we use an iterative solution to solve the problem. we use stack to demonstrate
- *  the recursive calls. we push and pop from the stack depends on the iterations until we count
- *  all the possible solutions
+ *  board, counted by the selected engine. engines which cannot count check first that the
+ *  board is solvable, and leave the counting to the backtracking (the stats are of the engine which
+ *  counted). the counting stops one solution past
+ *  the limit, so "is there exactly one solution" is answered with limit 1.
  *
  *  @param board - the actual game board
- *  @return - number of possible solutions
+ *  @param limit - the most solutions to report (0 = count them all)
+ *  @param overflow - set to 1 if the board has more than limit solutions, 0 otherwise
+ *  @return - number of possible solutions (at most limit)
  */
-int getNumSolutions(Board* board);
+unsigned long getNumSolutions(Board* board, unsigned long limit, int* overflow);
+
+/*
+ * enumerateSolutions
+ *
+ *  This function goes over the solutions of the board with the selected engine (with the backtracking, if the
+ *  engine cannot enumerate, as for a 9x9 board when no engine was selected). for each solution
+ *  the board's empty cells are filled with it and the callback is called, then emptied again.
+ *
+ *  @param board - the board (usually a copy of the game board)
+ *  @param onSolution - called for every solution, returns 0 in order to stop the enumeration
+ *  @param data - passed to the callback
+ *  @return - number of solutions visited
+ */
+unsigned long enumerateSolutions(Board* board, int (*onSolution)(Board *board, void *data), void *data);
+
+/*
+ * solveBoard
+ *
+ *  This function solves the board with the selected engine and fills the board with the solution.
+ *  the naked and hidden singles are filled first, so the engine gets a smaller board, and boards which
+ *  the all-different matching finds unsolvable are not searched at all.
+ *
+ *  @param board - the board to solve (usually a copy of the game board)
+ *  @return - 1 if solved, 0 if the board is unsolvable
+ */
+int solveBoard(Board* board);
+
+/*
+ * selectSolver
+ *
+ *  This function selects the engine which is used for validate, hint, generate and num_solutions.
+ *
+ *  @param name - the engine's name (see getEngineName)
+ *  @return - 1 if the engine was selected, 0 if there is no such engine
+ */
+int selectSolver(char* name);
+
+/*
+ * getSolverName
+ *
+ *  This function returns the name of the selected engine
+ *
+ *  @return - the engine's name
+ */
+char* getSolverName();
+
+/*
+ * getEngineName
+ *
+ *  This function returns the name of an engine in the registry
+ *
+ *  @param index - the engine's index
+ *  @return - the engine's name, NULL if there are less engines
+ */
+char* getEngineName(int index);
+
+/*
+ * getLastSolverName
+ *
+ *  This function returns the name of the engine which ran the last solve or count
+ *
+ *  @return - the engine's name
+ */
+char* getLastSolverName();
+
+/*
+ * getSearchNodes
+ *
+ *  This function returns the number of search nodes the last solve or count has visited
+ *
+ *  @return - number of nodes
+ */
+unsigned long getSearchNodes();
+
+/*
+ * getSkippedNodes
+ *
+ *  This function returns the number of search nodes the last solve or count has skipped, by backjumping
+ *  and by nogoods (0 for the engines which do not skip nodes)
+ *
+ *  @return - number of skipped nodes
+ */
+unsigned long getSkippedNodes();
 
 /*
  * markErrors
@@ -88,6 +174,20 @@ int getNumSolutions(Board* board);
  */
 void markErrors(Board* board, int row, int column);
 
+/*
+ * markMovesErrors
+ *
+ *  This function is called after the moves of a turn were applied (undo or redo of a turn) - it updates the
+ *  error flags once for all the rows, columns and blocks the moves have changed, instead of marking the
+ *  errors around every move.
+ *
+ *  @param board - the actual game board
+ *  @param moves - the turn's moves
+ *  @param movesNum - number of moves
+ *  @return -
+ */
+void markMovesErrors(Board* board, Move* moves, int movesNum);
+
 /*
  * markAllBoardErrors
  * REPLACE - check if it is correctly, modified isn't even used
@@ -3,6 +3,8 @@
  *
  *  This module describes the stack data structure which we are using in order to simulate
  *  recursive calls.
+ *  A stack of the main thread can be kept in the command's arena (initArenaStack), so a solve does not
+ *  allocate it by malloc. the counting threads use initStack.
  *  The functions here are directly related to the structure.
  *  Memory management of the stack is also done here
  */
@@ -10,6 +12,13 @@
 #include <stdlib.h>
 #include <string.h>
 #include "stack.h"
+#include "arena.h"
+
+#define MIN_TRAIL 64 /* initial number of pairs in the trail */
+
+/* private methods declaration: */
+void growStack(Stack* stack);
+void growTrail(Stack* stack);
 
 /* Public methods: */
 
@@ -17,16 +26,46 @@
  * initStack
  *
  *  This function initializes new stack structure, with no nodes
+ *  @param capacity - the number of nodes to allocate in advance (the deepest expected recursion)
  *  @return - pointer to the new stack
  */
-Stack* initStack() {
+Stack* initStack(int capacity) {
 	/* memory allocation for the new stack */
     Stack* newStack = malloc(sizeof(Stack));
     if (newStack == NULL) {
 		exit(0);
 	}
-    newStack->currentNode = NULL; /*no nodes in the stack*/
+    newStack->capacity = capacity>0 ? capacity : 1;
+    newStack->nodes = malloc(newStack->capacity*sizeof(StackNode));
+    newStack->trailCapacity = MIN_TRAIL;
+    newStack->trail = malloc(2*newStack->trailCapacity*sizeof(int));
+    if (newStack->nodes == NULL || newStack->trail == NULL) {
+		exit(0);
+	}
+    newStack->length=0; /*no nodes in the stack*/
+    newStack->trailLength=0;
+    newStack->inArena=0;
+
+    return newStack;
+}
+
+/*
+ * initArenaStack
+ *
+ *  This function initializes new stack structure, with no nodes, in the command's arena (main thread only).
+ *  its memory is valid until the arena is rewound below it.
+ *  @param capacity - the number of nodes to allocate in advance (the deepest expected recursion)
+ *  @return - pointer to the new stack
+ */
+Stack* initArenaStack(int capacity) {
+    Stack* newStack = arenaAlloc(sizeof(Stack));
+    newStack->capacity = capacity>0 ? capacity : 1;
+    newStack->nodes = arenaAlloc(newStack->capacity*sizeof(StackNode));
+    newStack->trailCapacity = MIN_TRAIL;
+    newStack->trail = arenaAlloc(2*newStack->trailCapacity*sizeof(int));
     newStack->length=0;
+    newStack->trailLength=0;
+    newStack->inArena=1;
 
     return newStack;
 }
@@ -42,41 +81,31 @@ Stack* initStack() {
  *  @return -
  */
 void push(Stack* stack, int i, int j, int k) {
-    StackNode* tmp = malloc(sizeof (StackNode));
-    if (tmp == NULL) {
-        exit(0);
-    }
+    StackNode* tmp;
+    if (stack->length == stack->capacity)
+    	growStack(stack);
+    tmp = &stack->nodes[stack->length];
     /* assignment of values to new node */
     tmp->column = i;
     tmp->row = j;
     tmp->value = k;
-    tmp->prev = stack->currentNode;
-    /* set the new node as a stacknode */
-    stack->currentNode = tmp;
+    tmp->trailMark = stack->trailLength;
     stack->length = stack->length + 1;
 }
 
 /*
  * pop
  *
- *  The function pops the top node from the stack and make the poppedNode pointer to point on it
- *  Please note that the allocated memory for the popped node happens *outside* of this function.
+ *  The function pops the top node from the stack and copies it to poppedNode
+ *  Please note that the memory for the popped node is *outside* of this function.
  *  @param stack - pointer to the current stack
- *  @param poppedNode - pointer to the node which is going to be the popped node
+ *  @param poppedNode - pointer to the node which is going to be the popped node (NULL if not needed)
  *  @return -
  */
 void pop(Stack* stack, StackNode* poppedNode) {
-	/* the memory for poppedNode has already been allocated */
-    StackNode* tmp = stack->currentNode;
-    poppedNode->column = tmp->column;
-    poppedNode->row = tmp->row;
-    poppedNode->value = tmp->value;
-
-    /* delete the top node from stack */
-    stack->currentNode = stack->currentNode->prev;
     stack->length = stack->length - 1;
-    /* free the popped node from memory */
-    free(tmp);
+    if (poppedNode != NULL)
+    	*poppedNode = stack->nodes[stack->length];
 }
 
 /*
@@ -89,7 +118,7 @@ void pop(Stack* stack, StackNode* poppedNode) {
  */
 
 StackNode* top(Stack* stack) {
-    return stack->currentNode;
+    return &stack->nodes[stack->length - 1];
 }
 
 /*
@@ -103,15 +132,96 @@ int isEmpty(Stack* stack) {
     return (stack->length == 0);
 }
 
+/*
+ * pushTrail
+ *
+ *  This function records a change on the trail: an index and the value it had before the change
+ *  @param stack - pointer to the current stack
+ *  @param index - the changed index
+ *  @param prevValue - the value before the change
+ *  @return -
+ */
+void pushTrail(Stack* stack, int index, int prevValue) {
+    if (stack->trailLength == stack->trailCapacity)
+    	growTrail(stack);
+    stack->trail[2*stack->trailLength] = index;
+    stack->trail[2*stack->trailLength+1] = prevValue;
+    stack->trailLength++;
+}
+
+/*
+ * popTrail
+ *
+ *  This function takes the last recorded change from the trail
+ *  @param stack - pointer to the current stack
+ *  @param index - pointer which gets the changed index
+ *  @param prevValue - pointer which gets the value before the change
+ *  @return -
+ */
+void popTrail(Stack* stack, int* index, int* prevValue) {
+    stack->trailLength--;
+    *index = stack->trail[2*stack->trailLength];
+    *prevValue = stack->trail[2*stack->trailLength+1];
+}
+
 /*
  * destroyStack
  *
- *  This function clears the stack from memory.
+ *  This function clears the stack from memory (a stack in the arena is left to the arena).
  *  @param stack - pointer to the current stack
  *  @return -
  */
 void destroyStack(Stack* stack) {
+	if (stack->inArena)
+		return;
+	free(stack->nodes);
+	free(stack->trail);
 	free(stack);
 }
 
 /* End of public methods */
+
+/* Private methods: */
+
+/*
+ * growStack
+ *
+ *  This function doubles the nodes array, in case the stack got deeper than its initial capacity.
+ *  in the arena the nodes are copied to a new array (the old one is given back with the rest of the stack).
+ */
+void growStack(Stack* stack) {
+    StackNode* nodes;
+    stack->capacity = 2*stack->capacity;
+    if (stack->inArena) {
+        nodes = arenaAlloc(stack->capacity*sizeof(StackNode));
+        memcpy(nodes, stack->nodes, stack->length*sizeof(StackNode));
+        stack->nodes = nodes;
+        return;
+    }
+    stack->nodes = realloc(stack->nodes, stack->capacity*sizeof(StackNode));
+    if (stack->nodes == NULL) {
+		exit(0);
+	}
+}
+
+/*
+ * growTrail
+ *
+ *  This function doubles the trail array when it gets full (copied to a new array in the arena, as the nodes)
+ */
+void growTrail(Stack* stack) {
+    int* trail;
+    stack->trailCapacity = 2*stack->trailCapacity;
+    if (stack->inArena) {
+        trail = arenaAlloc(2*stack->trailCapacity*sizeof(int));
+        memcpy(trail, stack->trail, 2*stack->trailLength*sizeof(int));
+        stack->trail = trail;
+        return;
+    }
+    stack->trail = realloc(stack->trail, 2*stack->trailCapacity*sizeof(int));
+    if (stack->trail == NULL) {
+		exit(0);
+	}
+}
+
+/* End of private methods */
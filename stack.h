@@ -3,6 +3,8 @@
  *
  *  This module describes the stack data structure which we are using in order to simulate
  *  recursive calls.
+ *  A stack of the main thread can be kept in the command's arena (initArenaStack), so a solve does not
+ *  allocate it by malloc. the counting threads use initStack.
  *  The functions here are directly related to the structure.
  *  Memory management of the stack is also done here
  */
@@ -16,22 +18,41 @@ typedef struct node {
     int column;
     int row;
     int value;
-    struct node* prev; /*pointer to the previous element */
+    int trailMark; /* the length of the trail when the node was pushed */
 } StackNode;
 
-/* The stack structure itself: has a pointer the top stackNode, and also has a length field*/
+/* The stack structure itself: the nodes are kept in an array which is allocated once (and grows only
+ * if it gets full), so pushing and popping do not allocate memory. the stack also has a trail - pairs
+ * of (index, previous value) which a search records before it changes its own state, and pops in order
+ * to restore that state when it backtracks */
 typedef struct stack {
-	StackNode* currentNode;
+	StackNode* nodes;
 	int length;
+	int capacity;
+	int* trail;
+	int trailLength; /* number of pairs in the trail */
+	int trailCapacity;
+	int inArena; /* 1 if the memory is in the arena - it is given back when the arena is rewound */
 } Stack;
 
 /*
  * initStack
  *
  *  This function initializes new stack structure, with no nodes
+ *  @param capacity - the number of nodes to allocate in advance (the deepest expected recursion)
  *  @return - pointer to the new stack
  */
-Stack* initStack();
+Stack* initStack(int capacity);
+
+/*
+ * initArenaStack
+ *
+ *  This function initializes new stack structure, with no nodes, in the command's arena (main thread only).
+ *  its memory is valid until the arena is rewound below it.
+ *  @param capacity - the number of nodes to allocate in advance (the deepest expected recursion)
+ *  @return - pointer to the new stack
+ */
+Stack* initArenaStack(int capacity);
 
 /*
  * push
@@ -48,10 +69,10 @@ void push(Stack* stack, int i, int j, int k);
 /*
  * pop
  *
- *  The function pops the top node from the stack and make the poppedNode pointer to point on it
- *  Please note that the allocated memory for the popped node happens *outside* of this function.
+ *  The function pops the top node from the stack and copies it to poppedNode
+ *  Please note that the memory for the popped node is *outside* of this function.
  *  @param stack - pointer to the current stack
- *  @param poppedNode - pointer to the node which is going to be the popped node
+ *  @param poppedNode - pointer to the node which is going to be the popped node (NULL if not needed)
  *  @return -
  */
 void pop(Stack* stack, StackNode* poppedNode);
@@ -75,10 +96,32 @@ StackNode* top(Stack* stack);
  */
 int isEmpty(Stack* stack);
 
+/*
+ * pushTrail
+ *
+ *  This function records a change on the trail: an index and the value it had before the change
+ *  @param stack - pointer to the current stack
+ *  @param index - the changed index
+ *  @param prevValue - the value before the change
+ *  @return -
+ */
+void pushTrail(Stack* stack, int index, int prevValue);
+
+/*
+ * popTrail
+ *
+ *  This function takes the last recorded change from the trail
+ *  @param stack - pointer to the current stack
+ *  @param index - pointer which gets the changed index
+ *  @param prevValue - pointer which gets the value before the change
+ *  @return -
+ */
+void popTrail(Stack* stack, int* index, int* prevValue);
+
 /*
  * destroyStack
  *
- *  This function clears the stack from memory.
+ *  This function clears the stack from memory (a stack in the arena is left to the arena).
  *  @param stack - pointer to the current stack
  *  @return -
  */
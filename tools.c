@@ -9,6 +9,7 @@
 #include <string.h>
 #include <time.h>
 #include "game.h"
+#include "mainAux.h"
 #include "solver.h"
 
 /* Public methods: */
@@ -45,9 +46,9 @@ int save (Board* board, char *path, int gameMode)
 		{
 			for(j=0;j<size;j++)
 			{
-				fprintf(f,"%d",board->cells[i][j].value);
+				fprintf(f,"%d",board->values[CELL(board,i,j)]);
 				/* prints '.' for fixed cells - if edit mode - fix the values */
-				if (board->cells[i][j].fixed==1 || (gameMode==2 && board->cells[i][j].value!=0))
+				if (board->fixed[CELL(board,i,j)]==1 || (gameMode==2 && board->values[CELL(board,i,j)]!=0))
 					fprintf(f,".");
 
 				fprintf(f, " ");
@@ -112,13 +113,13 @@ int load (char *path, Board** board, int mode)
 					if (data[strlen(data)-1] == '.')
 					{
 						if(mode==1) /*solve MODE*/
-							(*board)->cells[i][j].fixed = 1;
+							(*board)->fixed[CELL((*board),i,j)] = 1;
 						else /*mode==2 ---> EDIT MODE*/
-							(*board)->cells[i][j].fixed = 0;
+							(*board)->fixed[CELL((*board),i,j)] = 0;
 						data[strlen(data)-1] = '\0';
 					}
 
-					(*board)->cells[i][j].value = atoi(data);
+					setCellValue((*board),i,j,atoi(data));
 
 					data = strtok(NULL,delimiters); /*skip a delimiter*/
 					/* instead of for loop, calculate the i,j values manually */
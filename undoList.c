@@ -1,11 +1,19 @@
 /*
  * undoList Module
  *
- *  This module describes the doubly linked list structure which we are using in order to handle
- *  undo and redo calls. Every time the board is changed, a new node which describes the change
- *  is added to the structure.
+ *  This module describes the undo log which we are using in order to handle undo and redo calls.
+ *  Every time the board is changed, the moves of the change (a turn) are appended to the log.
+ *  The moves of all the turns are kept one after the other in one array, and the turns are the
+ *  offsets of their ends in it, so recording a turn does not allocate memory (unless the log gets
+ *  full), and dropping the undone turns is only moving the log's end back.
+ *  The log also keeps a checkpoint - a copy of the board's state before the first turn - so going back
+ *  to the beginning (reset) is a single copy instead of undoing every turn.
+ *  Only a window of turns around the current one is kept in memory, up to the history budget (a number
+ *  of moves). The turns before the window are spilled to a temporary file, and the undone turns after it
+ *  to another one, both in the binary form of the moves, and they are read back when undo or redo gets
+ *  to them. Each file is a stack - the turn next to the window is on its top.
  *  The functions here are directly related to the structure.
- *  Memory management of the stack is also done here.
+ *  Memory management of the log is also done here.
  */
 
 #include <stdio.h>
@@ -13,9 +21,26 @@
 #include <string.h>
 #include "undoList.h"
 
+#define MIN_MOVES 64 /* initial capacity of the moves array */
+#define MIN_TURNS 64 /* initial capacity of the turns array */
+#define DEFAULT_HISTORY_BUDGET 1048576 /* moves kept in memory by default (12MB) */
+
+static int historyBudget = DEFAULT_HISTORY_BUDGET;
+
+/* the number of moves of turn t, which is in memory */
+#define TURN_SIZE(list,t) ((list)->turnEnd[(t)-(list)->firstTurn+1] - (list)->turnEnd[(t)-(list)->firstTurn])
+
 /* Private methods declaration */
-void clearBeyond(Node* cur);
-void destroyNode(Node* newNode);
+void growMoves(List* undoList, int movesNum);
+void growTurns(List* undoList, int turnsNum);
+void fitBudget(List* undoList, int keep);
+void spillOlder(List* undoList, int turnsNum);
+void spillNewer(List* undoList, int turnsNum);
+void loadOlder(List* undoList, int turn);
+void loadNewer(List* undoList, int turn);
+void pushTurn(FILE* file, long* end, Move* moves, int movesNum);
+int peekTurn(FILE* file, long end);
+void popTurn(FILE* file, long* end, Move* moves, int movesNum);
 
 
 /* Public methods: */
@@ -23,128 +48,187 @@ void destroyNode(Node* newNode);
 /*
  * initList
  *
- *  This function initializes new list structure, with a single dummy node (has a -1 value for
- *  number of moves. this dummy node will be useful for detecting if we got to the beginning
- *  of the list.
- *  @return - pointer to the new list
+ *  This function initializes new log structure, with no turns
+ *  @return - pointer to the new log
  */
 List* initList()
 {
 	List* newList;
-	Node* newNode;
 	newList = malloc(sizeof(List));
-	newNode = malloc(sizeof(Node));
-	if(!newList || !newNode)
+	if(!newList)
 	{
 		printf("Error: malloc has failed\n");
 		exit(0);
 		return NULL;
 	}
-	/*dummy node preparation*/
-	newNode->movesNum = -1;
-	newNode->moves = NULL;
-	newNode->prev = NULL;
-	newNode->next = NULL;
-
-	/*dummy node assignment*/
-	newList->current = newNode;
+	newList->movesCapacity = MIN_MOVES;
+	newList->moves = malloc(newList->movesCapacity*sizeof(Move));
+	newList->turnsCapacity = MIN_TURNS;
+	newList->turnEnd = malloc((newList->turnsCapacity+1)*sizeof(int));
+	if(!newList->moves || !newList->turnEnd)
+	{
+		printf("Error: malloc has failed\n");
+		exit(0);
+		return NULL;
+	}
+	/* an empty log: only the beginning of the log */
+	newList->turnEnd[0] = 0;
+	newList->olderFile = NULL;
+	newList->newerFile = NULL;
+	newList->checkpoint = NULL;
+	newList->checkpointSize = 0;
+	clearList(newList);
 	return newList;
 }
 
 /*
- * insertSingleMove
+ * recordMove
  *
- *  insert a single move to a node
- *  @param moves - 2d moves array
- *  @param moveNum - the current move number out of all moves in current turn
- *  @param x - x coordinate
- *  @param y - y coordinate
+ *  This function appends a move to the turn which is being recorded. the first move of a turn drops
+ *  the turns which were undone (they cannot be redone after the board was changed)
+ *  @param undoList - pointer to the log
+ *  @param cell - the cell's index (row*boardsize+column)
  *  @param prevValue - value before move
- *  @param z - new value to be assigned
-
+ *  @param value - new value to be assigned
  *  @return -
  */
-void insertSingleMove(int** moves, int moveNum, int x, int y, int prevValue, int z){
-	int* oneMove = malloc(4*sizeof(int));
-	if(!oneMove)
+void recordMove(List* undoList, int cell, int prevValue, int value)
+{
+	Move* move;
+	if(!undoList->recording)
 	{
-		printf("Error: malloc has failed\n");
-		exit(0);
+		/* the log ends at the current turn, which is in memory or just before it */
+		undoList->movesNum = undoList->turnEnd[undoList->current - undoList->firstTurn + 1];
+		undoList->lastTurn = undoList->current;
+		undoList->turnsNum = undoList->current;
+		undoList->newerEnd = 0;
+		undoList->recording = 1;
 	}
+	growMoves(undoList, undoList->movesNum+1);
+	move = &undoList->moves[undoList->movesNum++];
+	move->cell = cell;
+	move->prevValue = prevValue;
+	move->value = value;
+}
 
-	/* values assignment */
-	oneMove[0]=x,oneMove[1]=y,oneMove[2]=prevValue,oneMove[3]=z;
-	moves[moveNum] = oneMove;
+/*
+ * endTurn
+ *
+ *  This function ends the turn which is being recorded, and makes it the current turn. nothing is
+ *  added to the log if no move was recorded.
+ *  @param undoList - pointer to the log
+ *  @return -
+ */
+void endTurn(List* undoList)
+{
+	if(!undoList->recording)
+		return;
+	growTurns(undoList, undoList->lastTurn - undoList->firstTurn + 2);
+	undoList->lastTurn++;
+	undoList->turnEnd[undoList->lastTurn - undoList->firstTurn + 1] = undoList->movesNum;
+	undoList->turnsNum = undoList->lastTurn;
+	undoList->current = undoList->lastTurn;
+	undoList->recording = 0;
+	fitBudget(undoList, undoList->current);
 }
 
 /*
- * updateMovesInNode
+ * turnMoves
  *
- *  insert all moves to a node (represents one user turn)
- *  @param newNode - pointer to the node to be created
- *  @param moves - 2d moves array
- *  @param moveNum - total number of moves in current turn
+ *  This function returns the moves of a turn. a spilled turn is read back to memory first. the moves
+ *  are valid until the next call to a function of the log.
+ *  @param undoList - pointer to the log
+ *  @param turn - the turn (1..turnsNum)
+ *  @param movesNum - gets the number of moves in the turn
+ *  @return - pointer to the turn's first move in the log
+ */
+Move* turnMoves(List* undoList, int turn, int* movesNum)
+{
+	if(turn < undoList->firstTurn)
+		loadOlder(undoList, turn);
+	else if(turn > undoList->lastTurn)
+		loadNewer(undoList, turn);
+	fitBudget(undoList, turn);
+	*movesNum = TURN_SIZE(undoList, turn);
+	return undoList->moves + undoList->turnEnd[turn - undoList->firstTurn];
+}
+
+/*
+ * setCheckpoint
+ *
+ *  This function keeps a copy of the board's state before the first turn of the log
+ *  @param undoList - pointer to the log
+ *  @param state - the board's storage block
+ *  @param size - the size of the block
  *  @return -
  */
-void updateMovesInNode(Node** newNode,int** moves, int movesNum){
-	*newNode = malloc(sizeof(Node));
-	if(!(*newNode))
+void setCheckpoint(List* undoList, const void* state, size_t size)
+{
+	if(undoList->checkpointSize != size)
 	{
-		printf("Error: malloc has failed\n");
-		exit(0);
+		free(undoList->checkpoint);
+		undoList->checkpoint = malloc(size);
+		if(!undoList->checkpoint)
+		{
+			printf("Error: malloc has failed\n");
+			exit(0);
+		}
+		undoList->checkpointSize = size;
 	}
-	/* values assignment */
-	(*newNode)->moves = moves;
-	(*newNode)->movesNum = movesNum;
-	(*newNode)->next = NULL;
-	(*newNode)->prev = NULL;
+	memcpy(undoList->checkpoint, state, size);
 }
 
 /*
- * addMove
+ * clearList
  *
- *  The function adds a new node (which was already prepared) to the list
- *  @param undoList - pointer to the current list
- *  @param newNode - pointer to a new node (which was already created and filled)
+ *  This function drops all the turns of the log (the checkpoint is kept)
+ *  @param undoList - pointer to the log
  *  @return -
  */
-void addMove(List* undoList, Node* newNode)
+void clearList(List* undoList)
 {
-	/*we have to clear beyond the current node
-	suppose that the clear beyond erases everything after current
-	and assigns null in the next field of current
-	*/
-	clearBeyond(undoList-> current);
-	newNode -> next = NULL;
-	undoList-> current -> next = newNode;
-	newNode -> prev = undoList-> current;
-	undoList-> current = undoList-> current -> next;
+	undoList->movesNum = 0;
+	undoList->firstTurn = 1;
+	undoList->lastTurn = 0;
+	undoList->turnsNum = 0;
+	undoList->current = 0;
+	undoList->recording = 0;
+	undoList->olderEnd = 0;
+	undoList->newerEnd = 0;
+}
+
+/*
+ * setHistoryBudget
+ *
+ *  This function sets the number of moves the logs keep in memory (the rest are spilled to temporary
+ *  files)
+ *  @param movesNum - the budget (at least 1)
+ *  @return -
+ */
+void setHistoryBudget(int movesNum)
+{
+	historyBudget = movesNum>0 ? movesNum : 1;
 }
 
 /*
  * destroyList
  *
- *  This function clears the entire list from memory.
- *  @param undoList - pointer to the current list
+ *  This function clears the entire log from memory.
+ *  @param undoList - pointer to the log
  *  @return -
  */
 void destroyList(List* undoList)
 {
 	/* if no memory was allocated at all, clear nothing */
 	if(undoList){
-		if(undoList->current)
-		{
-			/* go to the beginning of the list */
-			while (undoList->current->prev != NULL)
-				{
-					undoList->current = undoList->current->prev;
-				}
-			/*clear from memory every node but the first one*/
-			clearBeyond(undoList->current);
-			/* also clear the first node */
-			destroyNode(undoList->current);
-		}
-		/* lastly, clear the list itself */
+		free(undoList->moves);
+		free(undoList->turnEnd);
+		free(undoList->checkpoint);
+		/* the temporary files are removed when they are closed */
+		if(undoList->olderFile)
+			fclose(undoList->olderFile);
+		if(undoList->newerFile)
+			fclose(undoList->newerFile);
 		free(undoList);
 	}
 }
@@ -155,62 +239,242 @@ void destroyList(List* undoList)
 /* Private methods: */
 
 /*
- * clearBeyond
+ * growMoves
  *
- *  This function clears each node which is placed after the current one.
- *  @param cur - pointer to the current pointed node in the list
- *  @return -
+ *  This function doubles the moves array until it has room for movesNum moves
+ */
+void growMoves(List* undoList, int movesNum)
+{
+	if(movesNum <= undoList->movesCapacity)
+		return;
+	while(undoList->movesCapacity < movesNum)
+		undoList->movesCapacity = 2*undoList->movesCapacity;
+	undoList->moves = realloc(undoList->moves, undoList->movesCapacity*sizeof(Move));
+	if(!undoList->moves)
+	{
+		printf("Error: realloc has failed\n");
+		exit(0);
+	}
+}
+
+/*
+ * growTurns
+ *
+ *  This function doubles the turns array until it has room for turnsNum turns
  */
-void clearBeyond(Node* cur)
+void growTurns(List* undoList, int turnsNum)
 {
-	Node* tempPointer;
+	if(turnsNum <= undoList->turnsCapacity)
+		return;
+	while(undoList->turnsCapacity < turnsNum)
+		undoList->turnsCapacity = 2*undoList->turnsCapacity;
+	undoList->turnEnd = realloc(undoList->turnEnd, (undoList->turnsCapacity+1)*sizeof(int));
+	if(!undoList->turnEnd)
+	{
+		printf("Error: realloc has failed\n");
+		exit(0);
+	}
+}
 
-	/* current pointed node is not the last one in the list */
-	if (cur->next != NULL)
+/*
+ * fitBudget
+ *
+ *  This function spills turns to the files if the memory holds more moves than the budget: down to half
+ *  of the budget, so the spilling is not done again on the next turn. the turns which are farther from
+ *  the kept turn are spilled first, and the kept turn stays in memory. if the temporary files cannot be
+ *  created, the turns stay in memory.
+ */
+void fitBudget(List* undoList, int keep)
+{
+	int first, last, size, older=0, newer=0;
+	if(undoList->movesNum <= historyBudget)
+		return;
+	if(!undoList->olderFile)
+	{
+		undoList->olderFile = tmpfile();
+		undoList->newerFile = tmpfile();
+		if(!undoList->olderFile || !undoList->newerFile)
+		{
+			if(undoList->olderFile)
+				fclose(undoList->olderFile);
+			if(undoList->newerFile)
+				fclose(undoList->newerFile);
+			undoList->olderFile = undoList->newerFile = NULL;
+			return;
+		}
+	}
+	first = undoList->firstTurn;
+	last = undoList->lastTurn;
+	size = undoList->movesNum;
+	while(size > historyBudget/2 && first < last)
 	{
-		cur = cur->next;
-		/* if we haven't got to the last node in the list */
-		while (cur->next != NULL)
+		if(keep-first >= last-keep)
 		{
-			/* save current node's pointer */
-			tempPointer=cur;
-			cur = cur->next;
-			/* free the data of the saved pointer and move on to the next one */
-			destroyNode(tempPointer);
+			size -= TURN_SIZE(undoList, first);
+			first++, older++;
+		}
+		else
+		{
+			size -= TURN_SIZE(undoList, last);
+			last--, newer++;
 		}
-		destroyNode(cur);
 	}
+	spillNewer(undoList, newer);
+	spillOlder(undoList, older);
 }
 
 /*
- * destroyList
+ * spillOlder
  *
- *  This function clears the entire node from memory. This function is used by the destroy list
- *  function.
- *  @param newNode - pointer to the node to be destroyed
- *  @return -
+ *  This function moves the first turnsNum turns of the memory to the older file
+ */
+void spillOlder(List* undoList, int turnsNum)
+{
+	int i, spilled, memoryTurns;
+	if(turnsNum == 0)
+		return;
+	for(i=0; i<turnsNum; i++)
+		pushTurn(undoList->olderFile, &undoList->olderEnd, undoList->moves + undoList->turnEnd[i],
+				undoList->turnEnd[i+1] - undoList->turnEnd[i]);
+	spilled = undoList->turnEnd[turnsNum];
+	memmove(undoList->moves, undoList->moves + spilled, (undoList->movesNum - spilled)*sizeof(Move));
+	memoryTurns = undoList->lastTurn - undoList->firstTurn + 1;
+	for(i=0; i<=memoryTurns-turnsNum; i++)
+		undoList->turnEnd[i] = undoList->turnEnd[i+turnsNum] - spilled;
+	undoList->movesNum -= spilled;
+	undoList->firstTurn += turnsNum;
+}
+
+/*
+ * spillNewer
+ *
+ *  This function moves the last turnsNum turns of the memory to the newer file (the last one first, so
+ *  the first of them is on the top)
+ */
+void spillNewer(List* undoList, int turnsNum)
+{
+	int i, index;
+	for(i=0; i<turnsNum; i++)
+	{
+		index = undoList->lastTurn - undoList->firstTurn;
+		pushTurn(undoList->newerFile, &undoList->newerEnd, undoList->moves + undoList->turnEnd[index],
+				undoList->turnEnd[index+1] - undoList->turnEnd[index]);
+		undoList->movesNum = undoList->turnEnd[index];
+		undoList->lastTurn--;
+	}
+}
+
+/*
+ * loadOlder
+ *
+ *  This function reads turns back from the older file to the beginning of the memory: down to the given
+ *  turn, and then more while they fit in half of the budget
+ */
+void loadOlder(List* undoList, int turn)
+{
+	int i, movesNum, loaded=0, turnsNum=0, memoryTurns, position;
+	long end = undoList->olderEnd;
+
+	/* the turns on the file's top which are read back */
+	while(undoList->firstTurn-turnsNum > turn
+			|| (end > 0 && loaded + peekTurn(undoList->olderFile, end) <= historyBudget/2))
+	{
+		movesNum = peekTurn(undoList->olderFile, end);
+		end -= sizeof(int) + movesNum*sizeof(Move);
+		loaded += movesNum;
+		turnsNum++;
+	}
+
+	/* make room for them before the turns in memory */
+	memoryTurns = undoList->lastTurn - undoList->firstTurn + 1;
+	growMoves(undoList, undoList->movesNum + loaded);
+	growTurns(undoList, memoryTurns + turnsNum);
+	memmove(undoList->moves + loaded, undoList->moves, undoList->movesNum*sizeof(Move));
+	for(i=memoryTurns; i>=0; i--)
+		undoList->turnEnd[i+turnsNum] = undoList->turnEnd[i] + loaded;
+
+	/* the top turn is the last of them */
+	position = loaded;
+	for(i=turnsNum; i>0; i--)
+	{
+		undoList->turnEnd[i] = position;
+		movesNum = peekTurn(undoList->olderFile, undoList->olderEnd);
+		position -= movesNum;
+		popTurn(undoList->olderFile, &undoList->olderEnd, undoList->moves + position, movesNum);
+	}
+	undoList->turnEnd[0] = 0;
+	undoList->movesNum += loaded;
+	undoList->firstTurn -= turnsNum;
+}
+
+/*
+ * loadNewer
+ *
+ *  This function reads turns back from the newer file to the end of the memory: up to the given turn,
+ *  and then more while they fit in half of the budget
  */
-void destroyNode(Node* newNode)
+void loadNewer(List* undoList, int turn)
+{
+	int movesNum, loaded=0;
+	while(undoList->lastTurn < turn
+			|| (undoList->newerEnd > 0 && loaded + peekTurn(undoList->newerFile, undoList->newerEnd) <= historyBudget/2))
+	{
+		movesNum = peekTurn(undoList->newerFile, undoList->newerEnd);
+		growMoves(undoList, undoList->movesNum + movesNum);
+		growTurns(undoList, undoList->lastTurn - undoList->firstTurn + 2);
+		popTurn(undoList->newerFile, &undoList->newerEnd, undoList->moves + undoList->movesNum, movesNum);
+		undoList->movesNum += movesNum;
+		undoList->lastTurn++;
+		undoList->turnEnd[undoList->lastTurn - undoList->firstTurn + 1] = undoList->movesNum;
+		loaded += movesNum;
+	}
+}
+
+/*
+ * pushTurn
+ *
+ *  This function writes a turn on the top of a file's stack: its moves and then their number
+ */
+void pushTurn(FILE* file, long* end, Move* moves, int movesNum)
+{
+	if(fseek(file, *end, SEEK_SET) != 0
+			|| fwrite(moves, sizeof(Move), movesNum, file) != (size_t)movesNum
+			|| fwrite(&movesNum, sizeof(int), 1, file) != 1)
+	{
+		printf("Error: cannot write the undo history\n");
+		exit(0);
+	}
+	*end += movesNum*sizeof(Move) + sizeof(int);
+}
+
+/*
+ * peekTurn
+ *
+ *  This function returns the number of moves of the turn on the top of a file's stack
+ */
+int peekTurn(FILE* file, long end)
 {
-	/* assuming that we already erased all the forward nodes
-	 * and we got a pointer to the previous node.
-	 */
 	int movesNum;
-	int i;
-	/* if no memory was allocated at all, clear nothing */
-	if(newNode){
-		movesNum = newNode->movesNum;
-		/* clear the 2d moves array */
-		for(i=0;i<movesNum;i++){
-			if(newNode->moves[i])
-				free(newNode->moves[i]);
-		}
-		if(newNode->moves)
-			free(newNode->moves);
-		newNode->next=NULL;
-		newNode->prev=NULL;
-		/* clear the node itself from memory */
-		free(newNode);
+	if(fseek(file, end - (long)sizeof(int), SEEK_SET) != 0 || fread(&movesNum, sizeof(int), 1, file) != 1)
+	{
+		printf("Error: cannot read the undo history\n");
+		exit(0);
+	}
+	return movesNum;
+}
+
+/*
+ * popTurn
+ *
+ *  This function reads the turn on the top of a file's stack (of movesNum moves) and removes it
+ */
+void popTurn(FILE* file, long* end, Move* moves, int movesNum)
+{
+	*end -= movesNum*sizeof(Move) + sizeof(int);
+	if(fseek(file, *end, SEEK_SET) != 0 || fread(moves, sizeof(Move), movesNum, file) != (size_t)movesNum)
+	{
+		printf("Error: cannot read the undo history\n");
+		exit(0);
 	}
 }
 
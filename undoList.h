@@ -1,82 +1,135 @@
 /*
  * undoList Module
  *
- *  This module describes the doubly linked list structure which we are using in order to handle
- *  undo and redo calls. Every time the board is changed, a new node which describes the change
- *  is added to the structure.
+ *  This module describes the undo log which we are using in order to handle undo and redo calls.
+ *  Every time the board is changed, the moves of the change (a turn) are appended to the log.
+ *  The moves of all the turns are kept one after the other in one array, and the turns are the
+ *  offsets of their ends in it, so recording a turn does not allocate memory (unless the log gets
+ *  full), and dropping the undone turns is only moving the log's end back.
+ *  The log also keeps a checkpoint - a copy of the board's state before the first turn - so going back
+ *  to the beginning (reset) is a single copy instead of undoing every turn.
+ *  Only a window of turns around the current one is kept in memory, up to the history budget (a number
+ *  of moves). The turns before the window are spilled to a temporary file, and the undone turns after it
+ *  to another one, both in the binary form of the moves, and they are read back when undo or redo gets
+ *  to them. Each file is a stack - the turn next to the window is on its top.
  *  The functions here are directly related to the structure.
- *  Memory management of the stack is also done here.
+ *  Memory management of the log is also done here.
  */
 
 #ifndef UNDOLIST_H_
 #define UNDOLIST_H_
 
-/* a double-linked list node struct. Each node has a 2D array which describes all the moves that occured
- * in one turn. for example: if the number of moves in one turn is 7, then the dimentions
- * of the array will be 7X4. (4 fields are required in order to describe a single move  */
-typedef struct Node {
-    int **moves;
-    int movesNum;
-    struct Node* next; /* Pointer to next node in the DLL */
-    struct Node* prev; /* Pointer to previous node in the DLL */
-} Node;
+#include <stdio.h>
+#include <stddef.h>
 
-/* a doubly-linked list struct */
+/* a single move: the cell (row*boardsize+column), its value before the move and its new value */
+typedef struct move {
+	int cell;
+	int prevValue;
+	int value;
+} Move;
+
+/* the undo log struct. the turns firstTurn..lastTurn are in memory: turn t is the moves
+ * turnEnd[t-firstTurn]..turnEnd[t-firstTurn+1]-1 of the moves array, and turnEnd[0] is 0.
+ * the turns before firstTurn are in the older file and the turns after lastTurn are in the newer file.
+ * the turns after the current one were undone, and can be redone */
 typedef struct List {
-	Node* current; /* this pointer points on the current move in the list */
+	Move* moves;
+	int movesNum; /* number of moves in memory */
+	int movesCapacity;
+	int* turnEnd;
+	int turnsCapacity;
+	int firstTurn;
+	int lastTurn;
+	int turnsNum; /* number of turns in the log (1..turnsNum) */
+	int current; /* the last turn which is applied on the board (0 - none) */
+	int recording; /* 1 while the moves of a new turn are recorded */
+	FILE* olderFile; /* the spilled turns - NULL until the log gets over the budget */
+	long olderEnd; /* the top of the older file's stack */
+	FILE* newerFile;
+	long newerEnd;
+	void* checkpoint; /* the board's storage block before the first turn (NULL if not set) */
+	size_t checkpointSize;
 } List;
 
 /*
  * initList
  *
- *  This function initializes new list structure, with a single dummy node (has a -1 value for
- *  number of moves. this dummy node will be useful for detecting if we got to the beginning
- *  of the list.
- *  @return - pointer to the new list
+ *  This function initializes new log structure, with no turns
+ *  @return - pointer to the new log
  */
 List* initList();
 
 /*
- * insertSingleMove
+ * recordMove
  *
- *  insert a single move to a node
- *  @param moves - 2d moves array
- *  @param moveNum - the current move number out of all moves in current turn
- *  @param x - x coordinate
- *  @param y - y coordinate
+ *  This function appends a move to the turn which is being recorded. the first move of a turn drops
+ *  the turns which were undone (they cannot be redone after the board was changed)
+ *  @param undoList - pointer to the log
+ *  @param cell - the cell's index (row*boardsize+column)
  *  @param prevValue - value before move
- *  @param z - new value to be assigned
+ *  @param value - new value to be assigned
+ *  @return -
+ */
+void recordMove(List* undoList, int cell, int prevValue, int value);
+
+/*
+ * endTurn
+ *
+ *  This function ends the turn which is being recorded, and makes it the current turn. nothing is
+ *  added to the log if no move was recorded.
+ *  @param undoList - pointer to the log
+ *  @return -
+ */
+void endTurn(List* undoList);
 
+/*
+ * turnMoves
+ *
+ *  This function returns the moves of a turn. a spilled turn is read back to memory first. the moves
+ *  are valid until the next call to a function of the log.
+ *  @param undoList - pointer to the log
+ *  @param turn - the turn (1..turnsNum)
+ *  @param movesNum - gets the number of moves in the turn
+ *  @return - pointer to the turn's first move in the log
+ */
+Move* turnMoves(List* undoList, int turn, int* movesNum);
+
+/*
+ * setCheckpoint
+ *
+ *  This function keeps a copy of the board's state before the first turn of the log
+ *  @param undoList - pointer to the log
+ *  @param state - the board's storage block
+ *  @param size - the size of the block
  *  @return -
  */
-void insertSingleMove(int** moves, int moveNum, int x, int y, int prevValue, int z);
+void setCheckpoint(List* undoList, const void* state, size_t size);
 
 /*
- * updateMovesInNode
+ * clearList
  *
- *  insert all moves to a node (represents one user turn)
- *  @param newNode - pointer to the node to be created
- *  @param moves - 2d moves array
- *  @param moveNum - total number of moves in current turn
+ *  This function drops all the turns of the log (the checkpoint is kept)
+ *  @param undoList - pointer to the log
  *  @return -
  */
-void updateMovesInNode(Node** newNode,int** moves, int movesNum);
+void clearList(List* undoList);
 
 /*
- * addMove
+ * setHistoryBudget
  *
- *  The function adds a new node (which was already prepared) to the list
- *  @param undoList - pointer to the current list
- *  @param newNode - pointer to a new node (which was already created and filled)
+ *  This function sets the number of moves the logs keep in memory (the rest are spilled to temporary
+ *  files)
+ *  @param movesNum - the budget (at least 1)
  *  @return -
  */
-void addMove(List* undoList, Node* newNode);
+void setHistoryBudget(int movesNum);
 
 /*
  * destroyList
  *
- *  This function clears the entire list from memory.
- *  @param undoList - pointer to the current list
+ *  This function clears the entire log from memory.
+ *  @param undoList - pointer to the log
  *  @return -
  */
 void destroyList(List* undoList);